@@ -0,0 +1,375 @@
+/*******************************************************************************************
+*
+*   raylib example - parallel, asynchronous shader compilation with completion polling
+*
+*   MyrlCompileShader() in example_geometry_shader.c asks for GL_COMPILE_STATUS right
+*   after glCompileShader(), which forces the driver to finish that shader before the next
+*   one is even submitted. Here a batch loader instead:
+*     1) submits the compile of every stage of every program, without asking for status
+*     2) submits the link of every program, again without asking for status
+*     3) polls each frame which programs are done
+*   With GL_KHR_parallel_shader_compile (or the ARB version) the driver compiles on its own
+*   threads and GL_COMPLETION_STATUS_KHR tells, without blocking, if a program is done.
+*   Without the extension status is still only asked for a few programs per frame, so the
+*   loading screen keeps updating while the driver works.
+*
+*   Compile/link errors are only looked up (and logged) for programs that failed.
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "raylib.h"
+#include "external/glad.h"
+#include "rlgl.h"
+#define GLFW_INCLUDE_NONE
+#include <external/glfw/include/GLFW/glfw3.h>      // Required for: glfwExtensionSupported(), glfwGetProcAddress()
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+    #define GL_MAX_SHADER_COMPILER_THREADS_KHR  0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+    #define GL_COMPLETION_STATUS_KHR            0x91B1
+#endif
+
+#define MAX_BATCH_PROGRAMS          128
+#define POLLS_PER_FRAME_NO_EXT      4       // blocking status queries per frame without the extension
+
+typedef void (*PFNMaxShaderCompilerThreads)(GLuint count);
+
+typedef enum {
+    PROGRAM_EMPTY = 0,
+    PROGRAM_COMPILING,                  // stages submitted
+    PROGRAM_LINKING,                    // link submitted
+    PROGRAM_READY,
+    PROGRAM_FAILED
+} ProgramState;
+
+typedef struct BatchProgram {
+    const char *vsCode;
+    const char *gsCode;
+    const char *fsCode;
+    unsigned int stages[3];
+    unsigned int id;
+    ProgramState state;
+} BatchProgram;
+
+typedef struct ShaderBatch {
+    BatchProgram programs[MAX_BATCH_PROGRAMS];
+    int count;
+    int readyCount;
+    int failedCount;
+    bool parallel;                      // driver supports completion status queries
+} ShaderBatch;
+
+// Enable driver side parallel compilation if available
+// NOTE: call once after InitWindow()
+bool InitParallelShaderCompile(void)
+{
+    PFNMaxShaderCompilerThreads maxThreads = NULL;
+
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) maxThreads = (PFNMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) maxThreads = (PFNMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+
+    if (maxThreads == NULL)
+    {
+        TRACELOG(LOG_INFO, "SHADER: Parallel shader compile not supported, status will be polled a few programs per frame");
+        return false;
+    }
+
+    maxThreads(0xFFFFFFFF);     // let the driver choose the number of threads
+    TRACELOG(LOG_INFO, "SHADER: Parallel shader compile enabled");
+    return true;
+}
+
+// Queue a program, nothing is sent to the driver yet
+int AddBatchProgram(ShaderBatch *batch, const char *vsCode, const char *gsCode, const char *fsCode)
+{
+    if (batch->count >= MAX_BATCH_PROGRAMS) return -1;
+
+    BatchProgram *p = &batch->programs[batch->count];
+    *p = (BatchProgram){ 0 };
+    p->vsCode = vsCode;
+    p->gsCode = gsCode;
+    p->fsCode = fsCode;
+    return batch->count++;
+}
+
+static unsigned int SubmitStage(const char *code, int type)
+{
+    if (code == NULL) return 0;
+
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &code, NULL);
+    glCompileShader(shader);        // no status query here, that would wait for this compile
+    return shader;
+}
+
+// Submit every stage of every program, then every link
+void SubmitShaderBatch(ShaderBatch *batch)
+{
+    for (int i = 0; i < batch->count; i++)
+    {
+        BatchProgram *p = &batch->programs[i];
+        p->stages[0] = SubmitStage(p->vsCode, GL_VERTEX_SHADER);
+        p->stages[1] = SubmitStage(p->gsCode, GL_GEOMETRY_SHADER);
+        p->stages[2] = SubmitStage(p->fsCode, GL_FRAGMENT_SHADER);
+        p->state = PROGRAM_COMPILING;
+    }
+
+    for (int i = 0; i < batch->count; i++)
+    {
+        BatchProgram *p = &batch->programs[i];
+        p->id = glCreateProgram();
+        for (int s = 0; s < 3; s++) if (p->stages[s] > 0) glAttachShader(p->id, p->stages[s]);
+
+        // same attribute locations raylib binds by default
+        glBindAttribLocation(p->id, 0, "vertexPosition");
+        glBindAttribLocation(p->id, 1, "vertexTexCoord");
+        glBindAttribLocation(p->id, 2, "vertexNormal");
+        glBindAttribLocation(p->id, 3, "vertexColor");
+
+        glLinkProgram(p->id);
+        p->state = PROGRAM_LINKING;
+    }
+}
+
+// Log why a program failed (only called for failures, these queries block)
+static void LogBatchProgramError(BatchProgram *p)
+{
+    char log[1024];
+
+    for (int s = 0; s < 3; s++)
+    {
+        if (p->stages[s] == 0) continue;
+
+        GLint success = 0;
+        glGetShaderiv(p->stages[s], GL_COMPILE_STATUS, &success);
+        if (success == GL_FALSE)
+        {
+            glGetShaderInfoLog(p->stages[s], sizeof(log), NULL, log);
+            printf("SHADER: [ID %i] Compile error: %s\n", p->stages[s], log);
+        }
+    }
+
+    glGetProgramInfoLog(p->id, sizeof(log), NULL, log);
+    printf("SHADER: [ID %i] Link error: %s\n", p->id, log);
+}
+
+static void FinishBatchProgram(ShaderBatch *batch, BatchProgram *p)
+{
+    GLint success = 0;
+    glGetProgramiv(p->id, GL_LINK_STATUS, &success);
+
+    if (success == GL_TRUE)
+    {
+        p->state = PROGRAM_READY;
+        batch->readyCount++;
+    }
+    else
+    {
+        LogBatchProgramError(p);
+        glDeleteProgram(p->id);
+        p->id = 0;
+        p->state = PROGRAM_FAILED;
+        batch->failedCount++;
+    }
+
+    for (int s = 0; s < 3; s++)
+    {
+        if (p->stages[s] == 0) continue;
+        if (p->id > 0) glDetachShader(p->id, p->stages[s]);
+        glDeleteShader(p->stages[s]);
+        p->stages[s] = 0;
+    }
+}
+
+// Check which programs are done, returns true when the whole batch is finished
+bool PollShaderBatch(ShaderBatch *batch)
+{
+    int blockingPolls = 0;
+
+    for (int i = 0; i < batch->count; i++)
+    {
+        BatchProgram *p = &batch->programs[i];
+        if (p->state != PROGRAM_LINKING) continue;
+
+        if (batch->parallel)
+        {
+            GLint done = 0;
+            glGetProgramiv(p->id, GL_COMPLETION_STATUS_KHR, &done);     // never blocks
+            if (done) FinishBatchProgram(batch, p);
+        }
+        else if (blockingPolls < POLLS_PER_FRAME_NO_EXT)
+        {
+            FinishBatchProgram(batch, p);       // blocks until this program is linked
+            blockingPolls++;
+        }
+    }
+
+    return ((batch->readyCount + batch->failedCount) == batch->count);
+}
+
+// Get a finished program as a raylib Shader (default locations are looked up)
+Shader GetBatchShader(ShaderBatch *batch, int index)
+{
+    Shader shader = { 0 };
+    BatchProgram *p = &batch->programs[index];
+
+    if (p->state != PROGRAM_READY) return (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+
+    shader.id = p->id;
+    shader.locs = (int *)RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+
+    shader.locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader.id, "vertexPosition");
+    shader.locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(shader.id, "vertexTexCoord");
+    shader.locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(shader.id, "vertexNormal");
+    shader.locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(shader.id, "vertexColor");
+    shader.locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(shader.id, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(shader.id, "matModel");
+    shader.locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader.id, "colDiffuse");
+    shader.locs[SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform(shader.id, "texture0");
+
+    return shader;
+}
+
+//----------------------------------------------------------------------------------
+// Test shaders, specialised with a #define so the driver sees NUM_TEST_PROGRAMS programs
+//----------------------------------------------------------------------------------
+#define NUM_TEST_PROGRAMS   64
+
+const char* vertexShaderSrc=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"in vec3 vertexNormal;\n"
+"uniform mat4 mvp;\n"
+"out vec3 fragNormal;\n"
+"void main()\n"
+"{\n"
+"    fragNormal = vertexNormal;\n"
+"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+"}\n";
+
+const char* fragmentShaderTemplate=
+"#version 330\n"
+"#define VARIANT %i\n"
+"in vec3 fragNormal;\n"
+"uniform vec4 colDiffuse;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    vec3 n = normalize(fragNormal);\n"
+"    float v = 0.0;\n"
+"    for (int i = 0; i < 16 + VARIANT; i++) v += sin(dot(n, vec3(i, VARIANT, 1.0)))*0.1;\n"
+"    finalColor = vec4(0.5 + 0.5*n*cos(v + float(VARIANT)), 1.0)*colDiffuse;\n"
+"}\n";
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - asynchronous shader compilation");
+
+    static ShaderBatch batch = { 0 };
+    batch.parallel = InitParallelShaderCompile();
+
+    char *fragmentSources[NUM_TEST_PROGRAMS];
+    for (int i = 0; i < NUM_TEST_PROGRAMS; i++)
+    {
+        fragmentSources[i] = (char *)RL_MALLOC(strlen(fragmentShaderTemplate) + 16);
+        sprintf(fragmentSources[i], fragmentShaderTemplate, i);
+        AddBatchProgram(&batch, vertexShaderSrc, NULL, fragmentSources[i]);
+    }
+
+    double start = GetTime();
+    SubmitShaderBatch(&batch);
+    double submitTime = GetTime() - start;
+    double loadTime = 0;
+    int loadingFrames = 0;
+    bool loaded = false;
+
+    Shader shaders[NUM_TEST_PROGRAMS] = { 0 };
+    Model model = LoadModelFromMesh(GenMeshKnot(1.0f, 2.0f, 64, 64));
+
+    Camera3D camera = { 0 };
+    camera.fovy = 45;
+    camera.position = (Vector3){ 0, 3, 8 };
+    camera.target = (Vector3){ 0, 0, 0 };
+    camera.up = (Vector3){ 0, 1, 0 };
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (!loaded)
+        {
+            loadingFrames++;
+            if (PollShaderBatch(&batch))
+            {
+                loadTime = GetTime() - start;
+                for (int i = 0; i < NUM_TEST_PROGRAMS; i++) shaders[i] = GetBatchShader(&batch, i);
+                printf("SHADER BATCH: %i programs submitted in %.2f ms, all done after %.2f ms and %i rendered frames (%i failed)\n",
+                    batch.count, submitTime*1000.0, loadTime*1000.0, loadingFrames, batch.failedCount);
+                loaded = true;
+            }
+        }
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+            ClearBackground(DARKGRAY);
+
+            if (!loaded)
+            {
+                // loading screen keeps animating while the driver compiles
+                float progress = (float)(batch.readyCount + batch.failedCount)/batch.count;
+                DrawText("Compiling shaders...", 250, 180, 30, WHITE);
+                DrawRectangleLines(200, 230, 400, 30, WHITE);
+                DrawRectangle(205, 235, (int)(390*progress), 20, LIME);
+                DrawCircle(400 + (int)(cosf(GetTime()*4.0f)*180), 300, 8, ORANGE);
+            }
+            else
+            {
+                BeginMode3D(camera);
+                    model.materials[0].shader = shaders[(int)(GetTime()*2.0)%NUM_TEST_PROGRAMS];
+                    DrawModel(model, (Vector3){ 0, 0, 0 }, 1.0f, WHITE);
+                EndMode3D();
+
+                DrawText(TextFormat("%i programs: submit %.2f ms, done after %.2f ms, %i frames drawn meanwhile",
+                    batch.count, submitTime*1000.0, loadTime*1000.0, loadingFrames), 20, 40, 10, WHITE);
+            }
+
+            DrawText(batch.parallel? "GL_KHR_parallel_shader_compile: ON" : "GL_KHR_parallel_shader_compile: not available", 20, 60, 10, WHITE);
+            DrawFPS(20, 10);
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    model.materials[0].shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };    // our shaders are unloaded below
+    UnloadModel(model);
+    for (int i = 0; i < NUM_TEST_PROGRAMS; i++)
+    {
+        if (loaded && (shaders[i].id != rlGetShaderIdDefault())) UnloadShader(shaders[i]);
+        RL_FREE(fragmentSources[i]);
+    }
+
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -0,0 +1,579 @@
+/*******************************************************************************************
+*
+*   raylib example - asynchronous texture streaming: worker thread decode + PBO upload
+*
+*   LoadTexture() decodes the file and uploads it on the main thread, a level with hundreds
+*   of textures freezes the game until the last one is on the GPU. Here:
+*     1) RequestStreamedTexture() returns a handle at once, drawing it shows a placeholder
+*     2) worker threads decode (LoadImage() or a GenImage*() generator) and convert to RGBA8
+*     3) once per frame UpdateTextureStreamer() copies decoded rows into a pixel unpack
+*        buffer (PBO) and issues glTexSubImage2D() from it, never more than the byte budget,
+*        big textures are uploaded in row slices over several frames
+*     4) when the last row is submitted the texture replaces the placeholder
+*   The staging memory is a persistently mapped ring guarded by fences when glBufferStorage()
+*   is available (GL 4.4, ARB_buffer_storage), otherwise an orphaned buffer per frame.
+*
+*   NOTE: LoadImage() and GenImage*() only touch CPU memory, calling them from workers is safe,
+*   every GL call stays on the main thread.
+*
+*   Keys: L streams a level of LEVEL_TEXTURES textures, S loads the same level synchronously,
+*         UP/DOWN change the per frame upload budget
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>         // Required for: sysconf()
+#include "raylib.h"
+#include "external/glad.h"
+#include "rlgl.h"
+#define GLFW_INCLUDE_NONE
+#include <external/glfw/include/GLFW/glfw3.h>      // Required for: glfwExtensionSupported(), glfwGetProcAddress()
+
+#ifndef GL_MAP_PERSISTENT_BIT
+    #define GL_MAP_PERSISTENT_BIT       0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+    #define GL_MAP_COHERENT_BIT         0x0080
+#endif
+
+#define MAX_STREAMED_TEXTURES       1024
+#define MAX_STREAM_WORKERS          16
+#define STAGING_SEGMENTS            3           // frames in flight for the persistent ring
+#define MAX_SLICES_PER_FRAME        64
+#define MIN_UPLOAD_BUDGET           (64*1024)   // at least one row of a 16K texture
+#define LEVEL_TEXTURES              300
+
+typedef void (*PFNBufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+typedef enum {
+    STREAM_EMPTY = 0,
+    STREAM_QUEUED,                      // waiting for a worker
+    STREAM_DECODED,                     // image ready, waiting for upload budget
+    STREAM_UPLOADING,                   // part of the rows submitted
+    STREAM_READY,
+    STREAM_FAILED
+} StreamState;
+
+typedef enum {
+    SOURCE_FILE = 0,
+    SOURCE_PERLIN,
+    SOURCE_CHECKED
+} StreamSource;
+
+typedef struct StreamedTexture {
+    StreamSource source;
+    char fileName[256];
+    int width, height, seed;            // generated sources
+    StreamState state;                  // only written by the GL thread
+    Image image;
+    int uploadedRows;
+    Texture2D texture;
+} StreamedTexture;
+
+typedef struct TextureStreamer {
+    StreamedTexture textures[MAX_STREAMED_TEXTURES];
+    int count;
+
+    // worker side: FIFO of handles to decode, FIFO of decoded handles
+    int pending[MAX_STREAMED_TEXTURES];
+    int pendingHead, pendingTail;
+    int decoded[MAX_STREAMED_TEXTURES];
+    int decodedHead, decodedTail;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool quit;
+    pthread_t workers[MAX_STREAM_WORKERS];
+    int workerCount;
+
+    // GL side
+    Texture2D placeholder;
+    int uploading;                      // handle with rows still to upload, -1 none
+    int budget;                         // bytes per frame
+    bool persistent;
+    unsigned int pbo[STAGING_SEGMENTS];
+    unsigned char *mapped;              // persistent mapping of the whole ring
+    GLsync fences[STAGING_SEGMENTS];
+    int segment;
+
+    // statistics
+    int uploadedBytes;                  // last frame
+    int readyCount;
+    int failedCount;
+} TextureStreamer;
+
+//----------------------------------------------------------------------------------
+// Workers: decode and convert, no GL
+//----------------------------------------------------------------------------------
+static void *StreamWorkerThread(void *arg)
+{
+    TextureStreamer *streamer = (TextureStreamer *)arg;
+
+    while (true)
+    {
+        pthread_mutex_lock(&streamer->lock);
+        while ((streamer->pendingHead == streamer->pendingTail) && !streamer->quit) pthread_cond_wait(&streamer->wake, &streamer->lock);
+        if (streamer->quit)
+        {
+            pthread_mutex_unlock(&streamer->lock);
+            break;
+        }
+        int handle = streamer->pending[streamer->pendingTail++%MAX_STREAMED_TEXTURES];
+        StreamedTexture request = streamer->textures[handle];
+        pthread_mutex_unlock(&streamer->lock);
+
+        Image image = { 0 };
+        switch (request.source)
+        {
+            case SOURCE_FILE: image = LoadImage(request.fileName); break;
+            case SOURCE_PERLIN: image = GenImagePerlinNoise(request.width, request.height, request.seed*request.width, 0, 4.0f); break;
+            case SOURCE_CHECKED: image = GenImageChecked(request.width, request.height, 8 + request.seed%8, 8 + request.seed%8,
+                ColorFromHSV((float)(request.seed*37%360), 0.7f, 0.9f), DARKGRAY); break;
+            default: break;
+        }
+        if ((image.data != NULL) && (image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)) ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        pthread_mutex_lock(&streamer->lock);
+        streamer->textures[handle].image = image;
+        streamer->decoded[streamer->decodedHead++%MAX_STREAMED_TEXTURES] = handle;
+        pthread_mutex_unlock(&streamer->lock);
+    }
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Streamer
+//----------------------------------------------------------------------------------
+// Allocate the staging buffers for the given budget
+static void LoadStagingBuffers(TextureStreamer *streamer)
+{
+    // glBufferStorage() is core in OpenGL 4.4, earlier versions need GL_ARB_buffer_storage
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    PFNBufferStorage bufferStorage = NULL;
+    if ((major > 4) || ((major == 4) && (minor >= 4)) || glfwExtensionSupported("GL_ARB_buffer_storage")) bufferStorage = (PFNBufferStorage)glfwGetProcAddress("glBufferStorage");
+
+    streamer->persistent = (bufferStorage != NULL);
+    streamer->segment = 0;
+
+    if (streamer->persistent)
+    {
+        // one buffer, STAGING_SEGMENTS budget sized segments, mapped for the streamer's lifetime
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &streamer->pbo[0]);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamer->pbo[0]);
+        bufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)streamer->budget*STAGING_SEGMENTS, NULL, flags);
+        streamer->mapped = (unsigned char *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)streamer->budget*STAGING_SEGMENTS, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (streamer->mapped == NULL)
+        {
+            glDeleteBuffers(1, &streamer->pbo[0]);
+            streamer->pbo[0] = 0;
+            streamer->persistent = false;
+        }
+    }
+
+    if (!streamer->persistent) glGenBuffers(STAGING_SEGMENTS, streamer->pbo);
+
+    TRACELOG(LOG_INFO, "STREAM: %s staging, %i KB per frame", streamer->persistent? "Persistently mapped" : "Orphaned PBO", streamer->budget/1024);
+}
+
+static void UnloadStagingBuffers(TextureStreamer *streamer)
+{
+    for (int i = 0; i < STAGING_SEGMENTS; i++)
+    {
+        if (streamer->fences[i] != NULL) glDeleteSync(streamer->fences[i]);
+        streamer->fences[i] = NULL;
+    }
+
+    if (streamer->persistent)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamer->pbo[0]);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &streamer->pbo[0]);
+    }
+    else glDeleteBuffers(STAGING_SEGMENTS, streamer->pbo);
+
+    memset(streamer->pbo, 0, sizeof(streamer->pbo));
+    streamer->mapped = NULL;
+}
+
+// NOTE: call after InitWindow(), workers = 0 uses one per core minus the main thread
+TextureStreamer *LoadTextureStreamer(int workers, int budget)
+{
+    TextureStreamer *streamer = (TextureStreamer *)RL_CALLOC(1, sizeof(TextureStreamer));
+
+    Image checked = GenImageChecked(64, 64, 8, 8, MAGENTA, BLACK);
+    streamer->placeholder = LoadTextureFromImage(checked);
+    UnloadImage(checked);
+
+    streamer->uploading = -1;
+    streamer->budget = (budget < MIN_UPLOAD_BUDGET)? MIN_UPLOAD_BUDGET : budget;
+    LoadStagingBuffers(streamer);
+
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (workers < 1) workers = 1;
+    if (workers > MAX_STREAM_WORKERS) workers = MAX_STREAM_WORKERS;
+
+    pthread_mutex_init(&streamer->lock, NULL);
+    pthread_cond_init(&streamer->wake, NULL);
+    for (int i = 0; i < workers; i++) pthread_create(&streamer->workers[i], NULL, StreamWorkerThread, streamer);
+    streamer->workerCount = workers;
+
+    return streamer;
+}
+
+void UnloadTextureStreamer(TextureStreamer *streamer)
+{
+    pthread_mutex_lock(&streamer->lock);
+    streamer->quit = true;
+    pthread_cond_broadcast(&streamer->wake);
+    pthread_mutex_unlock(&streamer->lock);
+    for (int i = 0; i < streamer->workerCount; i++) pthread_join(streamer->workers[i], NULL);
+
+    for (int i = 0; i < streamer->count; i++)
+    {
+        if (streamer->textures[i].image.data != NULL) UnloadImage(streamer->textures[i].image);
+        if (streamer->textures[i].texture.id != 0) UnloadTexture(streamer->textures[i].texture);
+    }
+
+    UnloadStagingBuffers(streamer);
+    UnloadTexture(streamer->placeholder);
+    pthread_mutex_destroy(&streamer->lock);
+    pthread_cond_destroy(&streamer->wake);
+    RL_FREE(streamer);
+}
+
+// Change the per frame upload budget, the staging buffers are reallocated (GL keeps old ones alive while in use)
+void SetTextureStreamerBudget(TextureStreamer *streamer, int budget)
+{
+    UnloadStagingBuffers(streamer);
+    streamer->budget = (budget < MIN_UPLOAD_BUDGET)? MIN_UPLOAD_BUDGET : budget;
+    LoadStagingBuffers(streamer);
+}
+
+static int QueueStreamedTexture(TextureStreamer *streamer, StreamedTexture request)
+{
+    if (streamer->count >= MAX_STREAMED_TEXTURES)
+    {
+        TRACELOG(LOG_WARNING, "STREAM: Too many textures, increase MAX_STREAMED_TEXTURES");
+        return -1;
+    }
+
+    pthread_mutex_lock(&streamer->lock);
+    int handle = streamer->count++;
+    request.state = STREAM_QUEUED;
+    streamer->textures[handle] = request;
+    streamer->pending[streamer->pendingHead++%MAX_STREAMED_TEXTURES] = handle;
+    pthread_cond_signal(&streamer->wake);
+    pthread_mutex_unlock(&streamer->lock);
+
+    return handle;
+}
+
+// Request a texture from a file, returns a handle at once
+int RequestStreamedTexture(TextureStreamer *streamer, const char *fileName)
+{
+    StreamedTexture request = { .source = SOURCE_FILE };
+    strncpy(request.fileName, fileName, sizeof(request.fileName) - 1);
+    return QueueStreamedTexture(streamer, request);
+}
+
+// Request a generated texture, returns a handle at once
+int RequestGeneratedTexture(TextureStreamer *streamer, StreamSource source, int width, int height, int seed)
+{
+    StreamedTexture request = { .source = source, .width = width, .height = height, .seed = seed };
+    return QueueStreamedTexture(streamer, request);
+}
+
+// Texture to draw for a handle: the placeholder until every row is uploaded
+Texture2D GetStreamedTexture(const TextureStreamer *streamer, int handle)
+{
+    if ((handle < 0) || (handle >= streamer->count) || (streamer->textures[handle].state != STREAM_READY)) return streamer->placeholder;
+    return streamer->textures[handle].texture;
+}
+
+typedef struct UploadSlice {
+    int handle;
+    int firstRow;
+    int rows;
+    size_t offset;                      // in the staging buffer
+} UploadSlice;
+
+// Upload decoded rows, at most budget bytes, call once per frame on the GL thread
+void UpdateTextureStreamer(TextureStreamer *streamer)
+{
+    UploadSlice slices[MAX_SLICES_PER_FRAME];
+    int sliceCount = 0;
+    size_t used = 0;
+    unsigned char *staging = NULL;
+    size_t segmentOffset = 0;
+
+    streamer->uploadedBytes = 0;
+
+    while (sliceCount < MAX_SLICES_PER_FRAME)
+    {
+        // continue the partially uploaded texture, or take the next decoded one
+        int handle = streamer->uploading;
+        if (handle < 0)
+        {
+            pthread_mutex_lock(&streamer->lock);
+            if (streamer->decodedTail != streamer->decodedHead) handle = streamer->decoded[streamer->decodedTail++%MAX_STREAMED_TEXTURES];
+            pthread_mutex_unlock(&streamer->lock);
+            if (handle < 0) break;
+            streamer->textures[handle].state = STREAM_DECODED;
+        }
+
+        StreamedTexture *texture = &streamer->textures[handle];
+        if (texture->image.data == NULL)
+        {
+            TRACELOG(LOG_WARNING, "STREAM: [%s] Failed to decode", (texture->source == SOURCE_FILE)? texture->fileName : "generated");
+            texture->state = STREAM_FAILED;
+            streamer->failedCount++;
+            continue;
+        }
+
+        size_t rowBytes = (size_t)texture->image.width*4;
+        int rows = (int)((streamer->budget - used)/rowBytes);
+        if (rows > texture->image.height - texture->uploadedRows) rows = texture->image.height - texture->uploadedRows;
+        if (rows <= 0)
+        {
+            streamer->uploading = handle;        // budget spent, continue next frame
+            break;
+        }
+
+        if (texture->texture.id == 0)
+        {
+            // Storage only, no data: with a PBO bound the NULL pointer would be offset 0 into it,
+            // so the staging buffer is unbound around the allocation
+            if (staging != NULL) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            texture->state = STREAM_UPLOADING;
+            glGenTextures(1, &texture->texture.id);
+            glBindTexture(GL_TEXTURE_2D, texture->texture.id);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texture->image.width, texture->image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            texture->texture.width = texture->image.width;
+            texture->texture.height = texture->image.height;
+            texture->texture.mipmaps = 1;
+            texture->texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+            if (staging != NULL) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamer->persistent? streamer->pbo[0] : streamer->pbo[streamer->segment]);
+        }
+
+        // staging memory for this frame, only once there is something to upload
+        if (staging == NULL)
+        {
+            if (streamer->persistent)
+            {
+                if (streamer->fences[streamer->segment] != NULL)
+                {
+                    // the GPU has had STAGING_SEGMENTS - 1 frames, this rarely waits
+                    glClientWaitSync(streamer->fences[streamer->segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                    glDeleteSync(streamer->fences[streamer->segment]);
+                    streamer->fences[streamer->segment] = NULL;
+                }
+                segmentOffset = (size_t)streamer->segment*streamer->budget;
+                staging = streamer->mapped + segmentOffset;
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamer->pbo[0]);
+            }
+            else
+            {
+                // orphan: the driver hands out fresh memory if the previous contents are still in use
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamer->pbo[streamer->segment]);
+                glBufferData(GL_PIXEL_UNPACK_BUFFER, streamer->budget, NULL, GL_STREAM_DRAW);
+                staging = (unsigned char *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, streamer->budget, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                if (staging == NULL)
+                {
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    streamer->uploading = handle;
+                    return;
+                }
+            }
+        }
+
+        memcpy(staging + used, (unsigned char *)texture->image.data + texture->uploadedRows*rowBytes, rows*rowBytes);
+        slices[sliceCount++] = (UploadSlice){ handle, texture->uploadedRows, rows, segmentOffset + used };
+        used += rows*rowBytes;
+        texture->uploadedRows += rows;
+
+        if (texture->uploadedRows == texture->image.height)
+        {
+            streamer->uploading = -1;
+            UnloadImage(texture->image);
+            texture->image = (Image){ 0 };
+        }
+        else streamer->uploading = handle;
+    }
+
+    if (staging == NULL) return;
+
+    if (!streamer->persistent) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // with a PBO bound the data pointer is an offset into it
+    GLint unpackAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int i = 0; i < sliceCount; i++)
+    {
+        StreamedTexture *texture = &streamer->textures[slices[i].handle];
+        glBindTexture(GL_TEXTURE_2D, texture->texture.id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slices[i].firstRow, texture->texture.width, slices[i].rows, GL_RGBA, GL_UNSIGNED_BYTE, (const void *)slices[i].offset);
+
+        if (slices[i].firstRow + slices[i].rows == texture->texture.height)
+        {
+            texture->state = STREAM_READY;      // swapped in, GL orders the upload before any draw using it
+            streamer->readyCount++;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);        // raylib uploads from client memory
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);    // rlUpdateTexture() does not set it
+
+    if (streamer->persistent) streamer->fences[streamer->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    streamer->segment = (streamer->segment + 1)%STAGING_SEGMENTS;
+    streamer->uploadedBytes = (int)used;
+}
+
+//----------------------------------------------------------------------------------
+// Level used by the example
+//----------------------------------------------------------------------------------
+typedef struct LevelTexture {
+    StreamSource source;
+    int size;
+} LevelTexture;
+
+static LevelTexture GetLevelTexture(int i)
+{
+    static const int sizes[4] = { 128, 256, 256, 512 };
+    LevelTexture level = { (i%10 == 0)? SOURCE_FILE : (i%2)? SOURCE_PERLIN : SOURCE_CHECKED, sizes[(i*7)%4] };
+    if (i%60 == 7) level.size = 2048;               // a few big ones, uploaded in slices over several frames
+    return level;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - async texture streaming");
+
+    const char *fileName = "resources/parrots.png";
+    int budget = 4*1024*1024;
+    TextureStreamer *streamer = LoadTextureStreamer(0, budget);
+
+    int handles[LEVEL_TEXTURES];
+    for (int i = 0; i < LEVEL_TEXTURES; i++) handles[i] = -1;
+    Texture2D syncTextures[LEVEL_TEXTURES] = { 0 };
+    bool syncLoaded = false;
+
+    float frameMs = 0.0f, worstFrameMs = 0.0f;
+    double loadStart = 0.0, loadSeconds = 0.0;
+    bool loading = false;
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        frameMs = GetFrameTime()*1000.0f;
+        if (loading && (frameMs > worstFrameMs)) worstFrameMs = frameMs;
+
+        if (IsKeyPressed(KEY_L) && !loading && (streamer->count + LEVEL_TEXTURES <= MAX_STREAMED_TEXTURES))
+        {
+            for (int i = 0; i < LEVEL_TEXTURES; i++)
+            {
+                LevelTexture level = GetLevelTexture(i);
+                if ((level.source == SOURCE_FILE) && FileExists(fileName)) handles[i] = RequestStreamedTexture(streamer, fileName);
+                else handles[i] = RequestGeneratedTexture(streamer, (level.source == SOURCE_FILE)? SOURCE_PERLIN : level.source, level.size, level.size, i);
+            }
+            loading = true;
+            loadStart = GetTime();
+            worstFrameMs = 0.0f;
+            syncLoaded = false;
+        }
+
+        if (IsKeyPressed(KEY_S) && !loading)
+        {
+            // the same level the classic way, the window freezes until it is done
+            double start = GetTime();
+            for (int i = 0; i < LEVEL_TEXTURES; i++)
+            {
+                if (syncTextures[i].id != 0) UnloadTexture(syncTextures[i]);
+                LevelTexture level = GetLevelTexture(i);
+                Image image = { 0 };
+                if ((level.source == SOURCE_FILE) && FileExists(fileName)) image = LoadImage(fileName);
+                else if (level.source == SOURCE_CHECKED) image = GenImageChecked(level.size, level.size, 8 + i%8, 8 + i%8, ColorFromHSV((float)(i*37%360), 0.7f, 0.9f), DARKGRAY);
+                else image = GenImagePerlinNoise(level.size, level.size, i*level.size, 0, 4.0f);
+                syncTextures[i] = LoadTextureFromImage(image);
+                UnloadImage(image);
+            }
+            loadSeconds = GetTime() - start;
+            worstFrameMs = (float)(loadSeconds*1000.0);
+            syncLoaded = true;
+        }
+
+        if (IsKeyPressed(KEY_UP)) SetTextureStreamerBudget(streamer, streamer->budget*2);
+        if (IsKeyPressed(KEY_DOWN)) SetTextureStreamerBudget(streamer, streamer->budget/2);
+
+        UpdateTextureStreamer(streamer);
+
+        if (loading && (streamer->readyCount + streamer->failedCount == streamer->count))
+        {
+            loading = false;
+            loadSeconds = GetTime() - loadStart;
+        }
+        //----------------------------------------------------------------------------------
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(RAYWHITE);
+
+            // thumbnails of the level, placeholders until streamed in
+            const int columns = 25, size = 30;
+            for (int i = 0; i < LEVEL_TEXTURES; i++)
+            {
+                Texture2D texture = syncLoaded? syncTextures[i] : GetStreamedTexture(streamer, handles[i]);
+                if (texture.id == 0) continue;
+                Rectangle dest = { 20.0f + (i%columns)*(size + 1), 90.0f + (i/columns)*(size + 1), (float)size, (float)size };
+                DrawTexturePro(texture, (Rectangle){ 0, 0, (float)texture.width, (float)texture.height }, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+            }
+
+            DrawText("L: stream level   S: load level synchronously   UP/DOWN: upload budget", 20, 10, 20, DARKGRAY);
+            DrawText(TextFormat("%s, %i workers, budget %i KB/frame, uploaded %i KB this frame", streamer->persistent? "persistent PBO" : "orphaned PBO",
+                streamer->workerCount, streamer->budget/1024, streamer->uploadedBytes/1024), 20, 40, 10, GRAY);
+            DrawText(TextFormat("ready %i/%i  failed %i   frame %.1f ms   worst frame while loading %.1f ms   level load %.2f s%s",
+                streamer->readyCount, streamer->count, streamer->failedCount, frameMs, worstFrameMs, loading? GetTime() - loadStart : loadSeconds,
+                syncLoaded? " (synchronous)" : ""), 20, 60, 10, loading? ORANGE : GRAY);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int i = 0; i < LEVEL_TEXTURES; i++) if (syncTextures[i].id != 0) UnloadTexture(syncTextures[i]);
+    UnloadTextureStreamer(streamer);
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -2,29 +2,188 @@
 *
 *   raylib example - Custom glfw Keyboard callback
 *
+*   The GLFW callbacks only push compact, timestamped events into a lock-free ring buffer,
+*   the game loop drains it once per frame. No printf in the callbacks, so event processing
+*   is never blocked, and events are handled in the order GLFW delivered them (two presses
+*   in one frame stay in order).
+*
+*   NOTE: the timestamp is glfwGetTimerValue() when GLFW dispatches the event, not when the
+*   OS received it (GLFW does not expose that). raylib calls glfwPollEvents() from EndDrawing()
+*   on the main thread, so all events of a frame are stamped during that one poll. What is
+*   measured is therefore:
+*     - offset: time from the previous drain to the dispatch, i.e. where in the frame the
+*       poll happened (the same for every event of a poll, give or take microseconds)
+*     - latency: time from the dispatch to the drain, i.e. how long events wait in the queue
+*       (frame pacing wait after the poll) before the simulation sees them
+*   Keyboard, mouse buttons, cursor and scroll come from callbacks, gamepads have no GLFW
+*   callback so their state is polled and changes are pushed into the same queue.
+*   raylib's own callbacks are chained, IsKeyPressed() and friends keep working.
 *
 ********************************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
 
 #include "raylib.h"
 #include <external/glfw/include/GLFW/glfw3.h>
 
+#define INPUT_QUEUE_SIZE    1024        // power of two
+#define MAX_GAMEPADS        4
+#define EVENT_LOG_SIZE      16
+
+typedef enum {
+    INPUT_EVENT_KEY = 0,
+    INPUT_EVENT_MOUSE_BUTTON,
+    INPUT_EVENT_MOUSE_MOVE,
+    INPUT_EVENT_MOUSE_SCROLL,
+    INPUT_EVENT_GAMEPAD_BUTTON,
+    INPUT_EVENT_GAMEPAD_AXIS
+} InputEventType;
+
+typedef struct InputEvent {
+    unsigned long long time;            // glfwGetTimerValue() ticks
+    unsigned char type;                 // InputEventType
+    unsigned char action;               // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    unsigned char mods;
+    unsigned char device;               // gamepad index
+    int code;                           // key, mouse button, gamepad button or axis
+    int scancode;
+    float x, y;                         // cursor position, scroll offset or axis value
+} InputEvent;
+
+// Single producer (GLFW callbacks), single consumer (game loop)
+typedef struct InputQueue {
+    InputEvent events[INPUT_QUEUE_SIZE];
+    atomic_uint head;                   // written by the producer
+    atomic_uint tail;                   // written by the consumer
+    atomic_uint dropped;
+} InputQueue;
+
+static InputQueue inputQueue = { 0 };
+
+// raylib's callbacks, called after ours
+static GLFWkeyfun raylibKeyCallback = NULL;
+static GLFWmousebuttonfun raylibMouseButtonCallback = NULL;
+static GLFWcursorposfun raylibCursorPosCallback = NULL;
+static GLFWscrollfun raylibScrollCallback = NULL;
+
+static GLFWgamepadstate gamepadState[MAX_GAMEPADS] = { 0 };
+
+static void PushInputEvent(InputQueue *queue, InputEvent event)
+{
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head - tail >= INPUT_QUEUE_SIZE)
+    {
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    queue->events[head & (INPUT_QUEUE_SIZE - 1)] = event;
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+}
+
+static bool PopInputEvent(InputQueue *queue, InputEvent *event)
+{
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    if (tail == head) return false;
+
+    *event = queue->events[tail & (INPUT_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
 static void MyKeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
-    if (key < 0) return;    // Security check, macOS fn key generates -1
+    if (key >= 0)    // Security check, macOS fn key generates -1
+    {
+        PushInputEvent(&inputQueue, (InputEvent){ .time = glfwGetTimerValue(), .type = INPUT_EVENT_KEY,
+            .action = (unsigned char)action, .mods = (unsigned char)mods, .code = key, .scancode = scancode });
+    }
 
-    if (action == GLFW_RELEASE) printf("Released: ");
-    else if(action == GLFW_PRESS) printf("Pressed: ");
-    else if(action == GLFW_REPEAT) printf("Held: ");
+    if (raylibKeyCallback != NULL) raylibKeyCallback(window, key, scancode, action, mods);
+}
 
-    // Check the exit key to set close window
-    if ((scancode == 9) && (action == GLFW_PRESS)) glfwSetWindowShouldClose(glfwGetCurrentContext(), GLFW_TRUE);
+static void MyMouseButtonCallback(GLFWwindow *window, int button, int action, int mods)
+{
+    PushInputEvent(&inputQueue, (InputEvent){ .time = glfwGetTimerValue(), .type = INPUT_EVENT_MOUSE_BUTTON,
+        .action = (unsigned char)action, .mods = (unsigned char)mods, .code = button });
 
-    printf("Key: %d     Scancode: %d     Key's Name:%s\n",key,scancode,
-        glfwGetKeyName(key,scancode));
+    if (raylibMouseButtonCallback != NULL) raylibMouseButtonCallback(window, button, action, mods);
+}
 
-//    printf("Key: %d = Scancode: %d",key,glfwGetKeyScancode(key));
+static void MyCursorPosCallback(GLFWwindow *window, double x, double y)
+{
+    PushInputEvent(&inputQueue, (InputEvent){ .time = glfwGetTimerValue(), .type = INPUT_EVENT_MOUSE_MOVE, .x = (float)x, .y = (float)y });
+
+    if (raylibCursorPosCallback != NULL) raylibCursorPosCallback(window, x, y);
+}
+
+static void MyScrollCallback(GLFWwindow *window, double x, double y)
+{
+    PushInputEvent(&inputQueue, (InputEvent){ .time = glfwGetTimerValue(), .type = INPUT_EVENT_MOUSE_SCROLL, .x = (float)x, .y = (float)y });
+
+    if (raylibScrollCallback != NULL) raylibScrollCallback(window, x, y);
+}
+
+// GLFW has no gamepad callback: compare with the previous state and push the changes
+// NOTE: timestamps are the poll time, call it once per frame right before draining
+static void PollGamepadEvents(void)
+{
+    for (int g = 0; g < MAX_GAMEPADS; g++)
+    {
+        GLFWgamepadstate state = { 0 };
+        if (!glfwJoystickIsGamepad(GLFW_JOYSTICK_1 + g) || !glfwGetGamepadState(GLFW_JOYSTICK_1 + g, &state)) continue;
+
+        unsigned long long now = glfwGetTimerValue();
+
+        for (int b = 0; b <= GLFW_GAMEPAD_BUTTON_LAST; b++)
+        {
+            if (state.buttons[b] != gamepadState[g].buttons[b])
+            {
+                PushInputEvent(&inputQueue, (InputEvent){ .time = now, .type = INPUT_EVENT_GAMEPAD_BUTTON,
+                    .action = state.buttons[b], .device = (unsigned char)g, .code = b });
+            }
+        }
+
+        for (int a = 0; a <= GLFW_GAMEPAD_AXIS_LAST; a++)
+        {
+            float delta = state.axes[a] - gamepadState[g].axes[a];
+            if ((delta > 0.01f) || (delta < -0.01f))
+            {
+                PushInputEvent(&inputQueue, (InputEvent){ .time = now, .type = INPUT_EVENT_GAMEPAD_AXIS,
+                    .device = (unsigned char)g, .code = a, .x = state.axes[a] });
+            }
+            else state.axes[a] = gamepadState[g].axes[a];     // keep the reference until it moves enough
+        }
+
+        gamepadState[g] = state;
+    }
+}
+
+static const char *GetInputEventText(InputEvent event)
+{
+    static const char *actions[3] = { "Released", "Pressed", "Held" };
+    const char *action = (event.action < 3)? actions[event.action] : "?";
+
+    switch (event.type)
+    {
+        case INPUT_EVENT_KEY:
+        {
+            const char *name = glfwGetKeyName(event.code, event.scancode);
+            return TextFormat("%s: Key: %d  Scancode: %d  Key's Name: %s", action, event.code, event.scancode, (name != NULL)? name : "-");
+        }
+        case INPUT_EVENT_MOUSE_BUTTON: return TextFormat("%s: Mouse button %d", action, event.code);
+        case INPUT_EVENT_MOUSE_MOVE: return TextFormat("Mouse move: %.0f, %.0f", event.x, event.y);
+        case INPUT_EVENT_MOUSE_SCROLL: return TextFormat("Mouse scroll: %.1f, %.1f", event.x, event.y);
+        case INPUT_EVENT_GAMEPAD_BUTTON: return TextFormat("%s: Gamepad %d button %d", action, event.device, event.code);
+        case INPUT_EVENT_GAMEPAD_AXIS: return TextFormat("Gamepad %d axis %d: %.2f", event.device, event.code, event.x);
+        default: return "Unknown";
+    }
 }
 
 //------------------------------------------------------------------------------------
@@ -42,23 +201,67 @@ int main(void)
     SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
 
-    glfwSetKeyCallback(glfwGetCurrentContext(), MyKeyCallback);
-    
-    // Main game loop  
+    GLFWwindow *window = glfwGetCurrentContext();
+    raylibKeyCallback = glfwSetKeyCallback(window, MyKeyCallback);
+    raylibMouseButtonCallback = glfwSetMouseButtonCallback(window, MyMouseButtonCallback);
+    raylibCursorPosCallback = glfwSetCursorPosCallback(window, MyCursorPosCallback);
+    raylibScrollCallback = glfwSetScrollCallback(window, MyScrollCallback);
+
+    const double tickSeconds = 1.0/(double)glfwGetTimerFrequency();
+
+    // Last drained events, with their dispatch time since the previous drain and their latency
+    char eventLog[EVENT_LOG_SIZE][128] = { 0 };
+    int eventLogCount = 0;
+    double maxLatency = 0.0, sumLatency = 0.0;
+    unsigned long long latencyCount = 0;
+    int frameEvents = 0;
+    unsigned long long lastDrain = glfwGetTimerValue();
+
+    // Main game loop
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
         // Update
         //----------------------------------------------------------------------------------
-        // TODO: Update your variables here
+        // Drain everything GLFW dispatched since the last drain, in dispatch order
+        PollGamepadEvents();
+
+        unsigned long long now = glfwGetTimerValue();
+        InputEvent event;
+        frameEvents = 0;
 
+        while (PopInputEvent(&inputQueue, &event))
+        {
+            double latency = (now - event.time)*tickSeconds;
+            if (latency > maxLatency) maxLatency = latency;
+            sumLatency += latency;
+            latencyCount++;
+            frameEvents++;
+
+            if (event.type == INPUT_EVENT_MOUSE_MOVE) continue;     // too many to log
+
+            // console output happens here, outside the callback
+            printf("%s\n", GetInputEventText(event));
+
+            memmove(eventLog[1], eventLog[0], (EVENT_LOG_SIZE - 1)*sizeof(eventLog[0]));
+            snprintf(eventLog[0], sizeof(eventLog[0]), "+%6.3f ms  latency %6.3f ms  %s",
+                (event.time - lastDrain)*tickSeconds*1000.0, latency*1000.0, GetInputEventText(event));
+            if (eventLogCount < EVENT_LOG_SIZE) eventLogCount++;
+        }
+
+        lastDrain = now;
         //----------------------------------------------------------------------------------
+
         // Draw
         //----------------------------------------------------------------------------------
         BeginDrawing();
 
             ClearBackground(BLACK);
 
-            DrawText("Press any key ... output is shown in the console...", 190, 200, 20, LIGHTGRAY);
+            DrawText("Press any key, click, scroll or use a gamepad ... also in the console", 20, 20, 20, LIGHTGRAY);
+            DrawText(TextFormat("Events this frame: %i   latency avg %.3f ms  max %.3f ms   dropped %u", frameEvents,
+                (latencyCount > 0)? sumLatency/latencyCount*1000.0 : 0.0, maxLatency*1000.0, atomic_load(&inputQueue.dropped)), 20, 50, 10, GRAY);
+
+            for (int i = 0; i < eventLogCount; i++) DrawText(eventLog[i], 20, 80 + i*22, 10, (i == 0)? ORANGE : LIGHTGRAY);
 
         EndDrawing();
         //----------------------------------------------------------------------------------
@@ -69,4 +272,4 @@ int main(void)
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     return 0;
-}
\ No newline at end of file
+}
@@ -33,6 +33,8 @@
 #define RLIGHTS_IMPLEMENTATION
 #include "rlights.h"
 
+#include "function_ImageKernels.c"
+
 const char* gbufferShader_vs="#version 300 es\n"
 "precision highp float;\n"
 "in vec3 vertexPosition;\n"
@@ -279,12 +281,7 @@ int main(void)
     
     // add some specular detail to the model material
     Image tmp_img2=GenImageChecked(256,256,32,32,BLACK,LIGHTGRAY);
-    unsigned char* pixel=tmp_img2.data;
-    for (int i=0;i<256*256;i++)
-        if (pixel[i*4]<128)
-            pixel[i*4+3]=255;
-        else
-            pixel[i*4+3]=10;
+    ImageThresholdChannel(&tmp_img2, 0, 3, 128, 255, 10);      // specular in alpha: 255 where red < 128, 10 elsewhere
 
     Texture texture_albedo_specular=LoadTextureFromImage(tmp_img2);
     UnloadImage(tmp_img2);
@@ -2,6 +2,9 @@
 *
 *   raylib example - generate a sound at runtime
 *
+*   The sound is generated by GenerateSoundWave() (function_GenerateSoundWave.c), the same
+*   code example_offline_sound_bake.c uses to prebake sound banks. If the baked file exists
+*   it is loaded instead of synthesising the sound at startup.
 *
 ********************************************************************************************/
 #include <stdio.h>
@@ -10,6 +13,10 @@
 
 #include "raylib.h"
 
+#include "function_GenerateSoundWave.c"
+
+#define BAKED_SOUND_FILE "baked_sounds/sound_00.wav"    // written by example_offline_sound_bake.c
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
@@ -27,23 +34,18 @@ int main(void)
 
     InitAudioDevice();
 
-    Wave my_wave;
-    my_wave.frameCount=10000;
-    my_wave.channels=1;
-    my_wave.data=malloc(my_wave.frameCount*sizeof(float));
-    my_wave.sampleRate=48000;
-    my_wave.sampleSize=32;
-
-    float* tmp_pointer=(float*)my_wave.data;
-    float volume=1.0;  
-    // FILL IN THE SOUND's AUDIO BUFFER WITH SAMPLES
-    for (int i=0;i<my_wave.frameCount;i++)
+    Sound my_sound;
+    if (FileExists(BAKED_SOUND_FILE))
         {
-        tmp_pointer[i]=sin((float)i/10.0)*volume;
-        volume-=1.0/(float)my_wave.frameCount;
+        my_sound=LoadSound(BAKED_SOUND_FILE);    // prebaked, nothing to synthesise
+        }
+        else
+        {
+        // FILL IN THE SOUND's AUDIO BUFFER WITH SAMPLES: sin(i/10) at 48 kHz, fading out
+        Wave my_wave=GenerateSoundWave(10000, 48000, 48000.0f/(20.0f*PI), 1.0f);
+        my_sound=LoadSoundFromWave(my_wave);
+        UnloadWave(my_wave);    // the sound keeps its own copy of the samples
         }
-
-    Sound my_sound=LoadSoundFromWave(my_wave);
     PlaySound(my_sound);
 
     while (!WindowShouldClose())    // Detect window close button or ESC key
@@ -66,6 +68,7 @@ int main(void)
     // De-Initialization
     //--------------------------------------------------------------------------------------
     UnloadSound(my_sound);
+    CloseAudioDevice();   // Close audio device
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     return 0;
@@ -3,6 +3,12 @@
 *   raylib geometry shader example 
 //  NOTE: the model drawn needs to have vertex colors
 *
+*   The same circles are also drawn without a geometry shader: one instance per triangle,
+*   a line strip of sides+1 vertices, with the vertex shader reading the triangle data
+*   from a texture buffer (gl_InstanceID selects the triangle, gl_VertexID the point on
+*   the circle). Geometry shaders are slow on many drivers, so both paths are timed over
+*   several mesh sizes at startup and the geometry shader is only used where it wins.
+*
 *   credits: https://github.com/Overv/Open.GL/blob/master/content/articles-en/geometry.md
 *   Example licensed under an unmodified zlib/libpng license, which is an OSI-certified,
 *   BSD-like license that allows static linking with closed source software
@@ -79,7 +85,7 @@ const char* geometryShaderSrc=
     "    for (int i = 0; i <= vSides[0]; i++) {\n"
     "        float ang = PI * 2.0 / vSides[0] * i;\n"
     "        vec3 offset = vec3(cos(ang) * 0.3, -sin(ang) * 0.4, 0.0);\n"
-    "        gl_Position = mvp*vec4(vPos[i] + offset,1.0);\n"
+    "        gl_Position = mvp*vec4(vPos[0] + offset,1.0);\n"
     "        fragColor = vColor[0]; fragTexCoord=vuv[0]; fragNormal=vNormal[0];\n"
     "        EmitVertex();\n"
     "    }\n"
@@ -99,6 +105,32 @@ const char* fragmentShaderSrc=
 "    finalColor = vec4(fragNormal,1.0);//texture2D(texture0,fragTexCoord)*colDiffuse*vec4(fragColor,1.0);\n"
 "}\n";
 
+// Instanced path: no vertex attributes, one instance per triangle
+const char* instancedVertexShaderSrc=
+"#version 330\n"
+"uniform samplerBuffer triangleData;\n"        // 2 texels per triangle: position, normal
+"uniform mat4 mvp;\n"
+"uniform float sides;\n"
+"out vec3 fragNormal;\n"
+"const float PI = 3.1415926;\n"
+"void main()\n"
+"{\n"
+"    vec3 pos = texelFetch(triangleData, gl_InstanceID*2).xyz;\n"
+"    fragNormal = texelFetch(triangleData, gl_InstanceID*2 + 1).xyz;\n"
+"    float ang = PI * 2.0 / sides * float(gl_VertexID);\n"
+"    vec3 offset = vec3(cos(ang) * 0.3, -sin(ang) * 0.4, 0.0);\n"
+"    gl_Position = mvp*vec4(pos + offset,1.0);\n"
+"}\n";
+
+const char* instancedFragmentShaderSrc=
+"#version 330\n"
+"in vec3 fragNormal;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    finalColor = vec4(fragNormal,1.0);\n"
+"}\n";
+
 
 // Compile custom shader and return shader id
 unsigned int MyrlCompileShader(const char *shaderCode, int type)
@@ -168,18 +200,35 @@ unsigned int MyrlLoadShaderCode(const char *vsCode, const char *gsCode, const ch
     if (fsCode != NULL) fragmentShaderId = MyrlCompileShader(fsCode, GL_FRAGMENT_SHADER);
 
     id = glCreateProgram();
-    glAttachShader(id, vertexShaderId);
-    glAttachShader(id, geometryShaderId);
-    glAttachShader(id, fragmentShaderId);
+    if (vertexShaderId > 0) glAttachShader(id, vertexShaderId);
+    if (geometryShaderId > 0) glAttachShader(id, geometryShaderId);
+    if (fragmentShaderId > 0) glAttachShader(id, fragmentShaderId);
     glLinkProgram(id);
-    glUseProgram(id);
 
-    if (id > 0) glDetachShader(id, vertexShaderId);
-    glDeleteShader(vertexShaderId);
-    if (id > 0) glDetachShader(id, geometryShaderId);
-    glDeleteShader(geometryShaderId);
-    if (id > 0) glDetachShader(id, fragmentShaderId);
-    glDeleteShader(fragmentShaderId);
+    if (vertexShaderId > 0) { glDetachShader(id, vertexShaderId); glDeleteShader(vertexShaderId); }
+    if (geometryShaderId > 0) { glDetachShader(id, geometryShaderId); glDeleteShader(geometryShaderId); }
+    if (fragmentShaderId > 0) { glDetachShader(id, fragmentShaderId); glDeleteShader(fragmentShaderId); }
+
+    GLint success = 0;
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+
+    if (success == GL_FALSE)
+    {
+        int maxLength = 0;
+        glGetProgramiv(id, GL_INFO_LOG_LENGTH, &maxLength);
+
+        if (maxLength > 0)
+        {
+            int length = 0;
+            char *log = (char *)RL_CALLOC(maxLength, sizeof(char));
+            glGetProgramInfoLog(id, maxLength, &length, log);
+            printf( "SHADER: [ID %i] Link error: %s\n", id, log);
+            RL_FREE(log);
+        }
+
+        glDeleteProgram(id);
+        id = 0;
+    }
 
     if (id == 0)
        {
@@ -229,6 +278,153 @@ Shader MyLoadShaderFromMemory(const char *vsCode, const char *gsCode, const char
 }
 
 
+//----------------------------------------------------------------------------------
+// Instanced circles: same output as the geometry shader, without a geometry shader
+//----------------------------------------------------------------------------------
+#define CIRCLE_SIDES            12
+#define BENCH_MESH_SIZES        5
+#define BENCH_DRAWS             20
+
+typedef struct CircleInstances {
+    unsigned int vao;               // empty, core profile needs one bound to draw
+    unsigned int buffer;            // texture buffer storage
+    unsigned int texture;
+    int triangleCount;
+    int sidesLoc;                   // location of uniform "sides" in the shader drawing them
+} CircleInstances;
+
+typedef struct CirclePathBench {
+    int triangleCount;
+    double geometryMs;              // per draw
+    double instancedMs;
+} CirclePathBench;
+
+// Copy the data the circles need (first vertex and its normal of each triangle) to a texture buffer
+// NOTE: shader is the one later passed to DrawCircleInstances(), its uniform locations are looked up here
+CircleInstances LoadCircleInstances(Mesh mesh, Shader shader)
+{
+    CircleInstances ci = { 0 };
+    ci.triangleCount = mesh.triangleCount;
+    ci.sidesLoc = GetShaderLocation(shader, "sides");
+
+    float *data = (float *)RL_MALLOC(mesh.triangleCount*8*sizeof(float));
+    for (int t = 0; t < mesh.triangleCount; t++)
+    {
+        int v = (mesh.indices != NULL)? mesh.indices[t*3] : t*3;
+        data[t*8 + 0] = mesh.vertices[v*3 + 0];
+        data[t*8 + 1] = mesh.vertices[v*3 + 1];
+        data[t*8 + 2] = mesh.vertices[v*3 + 2];
+        data[t*8 + 3] = 1.0f;
+        data[t*8 + 4] = (mesh.normals != NULL)? mesh.normals[v*3 + 0] : 0.0f;
+        data[t*8 + 5] = (mesh.normals != NULL)? mesh.normals[v*3 + 1] : 0.0f;
+        data[t*8 + 6] = (mesh.normals != NULL)? mesh.normals[v*3 + 2] : 1.0f;
+        data[t*8 + 7] = 0.0f;
+    }
+
+    glGenBuffers(1, &ci.buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, ci.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, mesh.triangleCount*8*sizeof(float), data, GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    RL_FREE(data);
+
+    glGenTextures(1, &ci.texture);
+    glBindTexture(GL_TEXTURE_BUFFER, ci.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, ci.buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    glGenVertexArrays(1, &ci.vao);
+
+    return ci;
+}
+
+void UnloadCircleInstances(CircleInstances ci)
+{
+    glDeleteVertexArrays(1, &ci.vao);
+    glDeleteTextures(1, &ci.texture);
+    glDeleteBuffers(1, &ci.buffer);
+}
+
+// Draw one line strip per triangle, model transform is applied like DrawMesh() does
+// NOTE: shader sampler triangleData must be set to unit 0
+void DrawCircleInstances(CircleInstances ci, Shader shader, Matrix transform)
+{
+    rlDrawRenderBatchActive();      // anything batched so far goes before our draw
+
+    Matrix matModel = MatrixMultiply(transform, rlGetMatrixTransform());
+    Matrix mvp = MatrixMultiply(MatrixMultiply(matModel, rlGetMatrixModelview()), rlGetMatrixProjection());
+    float sides = CIRCLE_SIDES;
+
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], mvp);
+    rlSetUniform(ci.sidesLoc, &sides, RL_SHADER_UNIFORM_FLOAT, 1);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, ci.texture);
+    glBindVertexArray(ci.vao);
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, CIRCLE_SIDES + 1, ci.triangleCount);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    rlDisableShader();
+}
+
+// Time both paths over meshes of increasing size
+// NOTE: must be called inside BeginMode3D(), the frame is cleared afterwards
+void BenchmarkCirclePaths(Shader geometryShader, Shader instancedShader, CirclePathBench *results)
+{
+    const int meshDetail[BENCH_MESH_SIZES] = { 8, 16, 32, 64, 128 };
+    Material material = LoadMaterialDefault();
+    material.shader = geometryShader;
+
+    for (int i = 0; i < BENCH_MESH_SIZES; i++)
+    {
+        Mesh mesh = GenMeshSphere(2, meshDetail[i], meshDetail[i]);
+        CircleInstances ci = LoadCircleInstances(mesh, instancedShader);
+        results[i].triangleCount = mesh.triangleCount;
+
+        // warm up both, the first draw may include driver shader specialisation
+        DrawMesh(mesh, material, MatrixIdentity());
+        DrawCircleInstances(ci, instancedShader, MatrixIdentity());
+        rlDrawRenderBatchActive();
+        glFinish();
+
+        double start = GetTime();
+        for (int d = 0; d < BENCH_DRAWS; d++) DrawMesh(mesh, material, MatrixIdentity());
+        glFinish();
+        results[i].geometryMs = (GetTime() - start)*1000.0/BENCH_DRAWS;
+
+        start = GetTime();
+        for (int d = 0; d < BENCH_DRAWS; d++) DrawCircleInstances(ci, instancedShader, MatrixIdentity());
+        glFinish();
+        results[i].instancedMs = (GetTime() - start)*1000.0/BENCH_DRAWS;
+
+        printf("CIRCLES: %6i triangles: geometry shader %.3f ms, instanced %.3f ms\n",
+            results[i].triangleCount, results[i].geometryMs, results[i].instancedMs);
+
+        UnloadCircleInstances(ci);
+        UnloadMesh(mesh);
+    }
+
+    // keep the material shader, it is unloaded by the caller
+    material.shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+    UnloadMaterial(material);
+
+    ClearBackground(DARKGRAY);
+}
+
+// Geometry shader only where it was measured faster, for the closest benchmarked mesh size
+bool UseGeometryShaderPath(const CirclePathBench *results, int triangleCount)
+{
+    int closest = 0;
+    for (int i = 1; i < BENCH_MESH_SIZES; i++)
+    {
+        if (abs(results[i].triangleCount - triangleCount) < abs(results[closest].triangleCount - triangleCount)) closest = i;
+    }
+
+    return (results[closest].geometryMs < results[closest].instancedMs);
+}
+
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
@@ -250,12 +446,21 @@ int main(void)
     camera.position=(Vector3){0,0,-10};
     camera.target=(Vector3){0,0,0};
     camera.up=(Vector3){0,1,0};
+    camera.projection=CAMERA_PERSPECTIVE;
 
     printf("About to compile shader....\n");   
     Shader base;
     base=MyLoadShaderFromMemory(vertexShaderSrc,geometryShaderSrc,fragmentShaderSrc);
 
-    testmodel.materials[0].shader=base;
+    Shader instanced=MyLoadShaderFromMemory(instancedVertexShaderSrc,NULL,instancedFragmentShaderSrc);
+    int triangleDataUnit=0;
+    SetShaderValue(instanced,GetShaderLocation(instanced,"triangleData"),&triangleDataUnit,SHADER_UNIFORM_INT);
+    CircleInstances circles=LoadCircleInstances(testmodel.meshes[0],instanced);
+
+    CirclePathBench bench[BENCH_MESH_SIZES]={0};
+    bool benchDone=false;
+    bool useGeometryShader=false;
+
     float rotation=0;
     
     Material default_material=LoadMaterialDefault();
@@ -264,19 +469,36 @@ int main(void)
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
     rotation+=GetFrameTime();
-    if (IsKeyDown(KEY_SPACE)) 
-        testmodel.materials[0].shader=base;
-        else
-        testmodel.materials[0].shader=default_material.shader;
+    if (IsKeyPressed(KEY_B)) benchDone=false;
         BeginDrawing();
         ClearBackground(DARKGRAY);
         BeginMode3D(camera);
+        if (!benchDone)
+        {
+            BenchmarkCirclePaths(base,instanced,bench);
+            useGeometryShader=UseGeometryShaderPath(bench,circles.triangleCount);
+            benchDone=true;
+        }
+
         testmodel.transform=MatrixMultiply( MatrixMultiply(MatrixIdentity(),MatrixRotateY(rotation)),
                                 MatrixTranslate(0,-2,-6));
-        DrawModel(testmodel,(Vector3){0,0,5},1.3,WHITE);
+        if (IsKeyDown(KEY_SPACE) && !useGeometryShader)
+        {
+            // same transform DrawModel() would build for position (0,0,5), scale 1.3
+            Matrix transform=MatrixMultiply(testmodel.transform,MatrixMultiply(MatrixScale(1.3,1.3,1.3),MatrixTranslate(0,0,5)));
+            DrawCircleInstances(circles,instanced,transform);
+        }
+        else
+        {
+            testmodel.materials[0].shader=IsKeyDown(KEY_SPACE)? base : default_material.shader;
+            DrawModel(testmodel,(Vector3){0,0,5},1.3,WHITE);
+        }
         EndMode3D();
 
-        DrawText("Press SPACE BAR for geom shader",20,20,20,WHITE);
+        DrawText("Press SPACE BAR for geom shader circles, B to benchmark again",20,20,20,WHITE);
+        DrawText(TextFormat("Circles path: %s",useGeometryShader? "geometry shader" : "instanced vertex pulling"),20,50,20,WHITE);
+        for (int i=0;i<BENCH_MESH_SIZES;i++)
+            DrawText(TextFormat("%6i tris: geometry %.3f ms, instanced %.3f ms",bench[i].triangleCount,bench[i].geometryMs,bench[i].instancedMs),20,80+i*20,10,WHITE);
 
         DrawFPS(0,0);
 
@@ -285,6 +507,11 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    testmodel.materials[0].shader=default_material.shader;
+    UnloadModel(testmodel);
+    UnloadCircleInstances(circles);
+    UnloadShader(base);
+    UnloadShader(instanced);
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
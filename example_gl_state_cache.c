@@ -0,0 +1,310 @@
+/*******************************************************************************************
+*
+*   raylib example - GL state cache (skip redundant shader, texture and framebuffer binds)
+*
+*   A thin shadow-state layer over the rlgl calls used by the examples in this repo.
+*   It remembers the bound program, the texture bound to each texture unit, the bound
+*   framebuffer and blend/depth/stencil enables, and only calls into rlgl/OpenGL when
+*   the requested state differs from the remembered one.
+*   Issued and elided calls are counted per frame.
+*
+*   NOTE: raylib's own batch (DrawText, DrawTexture, ... EndShaderMode, EndTextureMode)
+*   changes GL state behind the cache's back. Call InvalidateGLStateAfterBatch() after
+*   such calls, or InvalidateGLStateCache() when in doubt.
+*
+*   Press C to toggle the cache on/off and compare the counters.
+*
+********************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+#define MAX_CACHED_TEXTURE_UNITS    16
+#define GL_STATE_UNKNOWN            -1
+
+typedef struct GLStateCache {
+    bool enabled;                       // when false every call is passed through (for comparison)
+
+    int program;
+    int activeUnit;
+    int textures[MAX_CACHED_TEXTURE_UNITS];
+    int framebuffer;
+    int colorBlend;                     // GL_STATE_UNKNOWN, 0 = disabled, 1 = enabled
+    int depthTest;
+    int depthMask;
+    int stencilTest;
+
+    int callsIssued;                    // per-frame counters
+    int callsElided;
+} GLStateCache;
+
+static GLStateCache glState = { 0 };
+
+// Forget everything we know about the GL state, next calls will all be issued
+void InvalidateGLStateCache(void)
+{
+    glState.program = GL_STATE_UNKNOWN;
+    glState.activeUnit = GL_STATE_UNKNOWN;
+    for (int i = 0; i < MAX_CACHED_TEXTURE_UNITS; i++) glState.textures[i] = GL_STATE_UNKNOWN;
+    glState.framebuffer = GL_STATE_UNKNOWN;
+    glState.colorBlend = GL_STATE_UNKNOWN;
+    glState.depthTest = GL_STATE_UNKNOWN;
+    glState.depthMask = GL_STATE_UNKNOWN;
+    glState.stencilTest = GL_STATE_UNKNOWN;
+}
+
+// Forget only the state raylib's render batch touches when it is flushed:
+// the program, the active texture unit and the texture bound to unit 0
+void InvalidateGLStateAfterBatch(void)
+{
+    glState.program = GL_STATE_UNKNOWN;
+    glState.activeUnit = GL_STATE_UNKNOWN;
+    glState.textures[0] = GL_STATE_UNKNOWN;
+}
+
+void InitGLStateCache(void)
+{
+    glState.enabled = true;
+    InvalidateGLStateCache();
+}
+
+void ResetGLStateCounters(void)
+{
+    glState.callsIssued = 0;
+    glState.callsElided = 0;
+}
+
+// Returns true when the call has to be issued, updates the remembered value and the counters
+static bool GLStateChange(int *cached, int value)
+{
+    if (glState.enabled && (*cached == value))
+    {
+        glState.callsElided++;
+        return false;
+    }
+
+    *cached = value;
+    glState.callsIssued++;
+    return true;
+}
+
+void CachedEnableShader(unsigned int id)
+{
+    if (GLStateChange(&glState.program, (int)id)) rlEnableShader(id);
+}
+
+void CachedEnableTexture(int unit, unsigned int id)
+{
+    if ((unit < 0) || (unit >= MAX_CACHED_TEXTURE_UNITS)) return;
+
+    // Nothing to do (not even a unit switch) if the texture is already bound to that unit
+    if (glState.enabled && (glState.textures[unit] == (int)id))
+    {
+        glState.callsElided++;
+        return;
+    }
+
+    if (GLStateChange(&glState.activeUnit, unit)) rlActiveTextureSlot(unit);
+    if (GLStateChange(&glState.textures[unit], (int)id)) rlEnableTexture(id);
+}
+
+// NOTE: id 0 means the default (screen) framebuffer
+void CachedEnableFramebuffer(unsigned int id)
+{
+    if (GLStateChange(&glState.framebuffer, (int)id))
+    {
+        if (id == 0) rlDisableFramebuffer();
+        else rlEnableFramebuffer(id);
+    }
+}
+
+void CachedColorBlend(bool enable)
+{
+    if (GLStateChange(&glState.colorBlend, enable))
+    {
+        if (enable) rlEnableColorBlend();
+        else rlDisableColorBlend();
+    }
+}
+
+void CachedDepthTest(bool enable)
+{
+    if (GLStateChange(&glState.depthTest, enable))
+    {
+        if (enable) rlEnableDepthTest();
+        else rlDisableDepthTest();
+    }
+}
+
+void CachedDepthMask(bool enable)
+{
+    if (GLStateChange(&glState.depthMask, enable))
+    {
+        if (enable) rlEnableDepthMask();
+        else rlDisableDepthMask();
+    }
+}
+
+void CachedStencilTest(bool enable)
+{
+    if (GLStateChange(&glState.stencilTest, enable))
+    {
+        if (enable) glEnable(GL_STENCIL_TEST);
+        else glDisable(GL_STENCIL_TEST);
+    }
+}
+
+const char* vs2="#version 330 core              \n"
+"layout (location = 0) in vec3 vertexPosition;\n"
+"layout (location = 1) in vec2 vertexTexCoord;\n"
+"out vec2 texCoord;\n"
+"void main() {\n"
+"    gl_Position = vec4(vertexPosition, 1.0);\n"
+"    texCoord = vertexTexCoord;\n"
+"}\n\0";
+
+const char* fs2="#version 330 core              \n"
+"out vec4 finalColor;\n"
+"in vec2 texCoord;\n"
+"uniform sampler2D mytexture0;\n"
+"uniform sampler2D mytexture1;\n"
+"uniform sampler2D mytexture2;\n"
+"uniform sampler2D mytexture3;\n"
+"uniform sampler2D mytexture4;\n"
+"uniform sampler2D mytexture5;\n"
+"uniform float tex_select;\n"
+"void main() {\n"
+"finalColor = vec4(1.0);\n"
+"    if (tex_select==0.0) finalColor = texture(mytexture0, texCoord);\n"
+"    if (tex_select==1.0) finalColor = texture(mytexture1, texCoord);\n"
+"    if (tex_select==2.0) finalColor = texture(mytexture2, texCoord);\n"
+"    if (tex_select==3.0) finalColor = texture(mytexture3, texCoord);\n"
+"    if (tex_select==4.0) finalColor = texture(mytexture4, texCoord);\n"
+"    if (tex_select==5.0) finalColor = texture(mytexture5, texCoord);\n"
+"}\n\0";
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    // -------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - GL state cache");
+
+    Shader shader_display = LoadShaderFromMemory(vs2,fs2);
+    int selectTexLoc = GetShaderLocation(shader_display, "tex_select");
+
+    // link our shader's samplers to texture units 0..5 (done once)
+    rlEnableShader(shader_display.id);
+    for (int i = 0; i < 6; i++) rlSetUniform(rlGetLocationUniform(shader_display.id, TextFormat("mytexture%i", i)), &i, RL_SHADER_UNIFORM_INT, 1);
+    rlDisableShader();
+
+    Color colors[6] = { RED, GREEN, BLUE, MAGENTA, ORANGE, GRAY };
+    Texture2D textures[6];
+    for (int i = 0; i < 6; i++)
+    {
+        Image tmp_image=GenImageColor(screenWidth,screenHeight,colors[i]);
+        textures[i]=LoadTextureFromImage(tmp_image);
+        UnloadImage(tmp_image);
+    }
+
+    // offscreen target the quad is drawn to before being shown on screen
+    RenderTexture2D target = LoadRenderTexture(screenWidth, screenHeight);
+
+    InitGLStateCache();
+
+    SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
+    //---------------------------------------------------------------------------------------
+    float tex_select=0.0;
+    int lastIssued=0, lastElided=0;
+    // Main game loop
+    while (!WindowShouldClose())
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyPressed(KEY_ONE))      tex_select=0.0;
+        if (IsKeyPressed(KEY_TWO))      tex_select=1.0;
+        if (IsKeyPressed(KEY_THREE))    tex_select=2.0;
+        if (IsKeyPressed(KEY_FOUR))    tex_select=3.0;
+        if (IsKeyPressed(KEY_FIVE))    tex_select=4.0;
+        if (IsKeyPressed(KEY_SIX))    tex_select=5.0;
+        if (IsKeyPressed(KEY_C))
+        {
+            glState.enabled = !glState.enabled;
+            InvalidateGLStateCache();
+        }
+
+        ResetGLStateCounters();
+
+        // Draw
+        // ---------------------------------------------------------------------------------
+        BeginDrawing();
+
+        // draw the quad 3 times to the offscreen target, like a multi-pass effect would
+        // (only the first pass of each frame should issue texture binds: all six units on the first
+        // frame, then unit 0 every frame since InvalidateGLStateAfterBatch() forgets it after the batch)
+        CachedEnableFramebuffer(target.id);
+        rlViewport(0, 0, screenWidth, screenHeight);
+        rlClearScreenBuffers();
+        for (int pass = 0; pass < 3; pass++)
+        {
+            CachedEnableShader(shader_display.id);
+            CachedColorBlend(false);
+            CachedDepthTest(false);
+            CachedDepthMask(false);
+            CachedStencilTest(false);
+
+            SetShaderValue(shader_display, selectTexLoc, &tex_select, SHADER_UNIFORM_FLOAT);
+            for (int i = 0; i < 6; i++) CachedEnableTexture(i, textures[i].id);
+
+            rlLoadDrawQuad();
+        }
+        CachedEnableFramebuffer(0);
+        rlViewport(0, 0, GetScreenWidth(), GetScreenHeight());
+
+        // from here on raylib's batch takes over, restore what it expects
+        CachedColorBlend(true);
+        CachedDepthMask(true);
+
+        ClearBackground(RAYWHITE);
+        DrawTexturePro(target.texture,
+        (Rectangle){0,0,screenWidth,-screenHeight},
+        (Rectangle){0,0,screenWidth,screenHeight},
+        (Vector2){0.0,0.0},
+        0,WHITE);
+
+        DrawText("Show textures (press key): [1][2][3][4][5][6]", 10, 70, 20, DARKGRAY);
+        DrawText(TextFormat("State cache: %s (press C)", glState.enabled? "ON" : "OFF"), 10, 100, 20, DARKGRAY);
+        DrawText(TextFormat("GL state calls last frame: %i issued, %i elided", lastIssued, lastElided), 10, 130, 20, DARKGRAY);
+
+        DrawFPS(10, 10);
+
+        EndDrawing();
+
+        // the batch was flushed inside EndDrawing()
+        InvalidateGLStateAfterBatch();
+
+        lastIssued = glState.callsIssued;
+        lastElided = glState.callsElided;
+        // -----------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int i = 0; i < 6; i++) UnloadTexture(textures[i]);
+    UnloadRenderTexture(target);
+    UnloadShader(shader_display);
+
+    CloseWindow();          // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*******************************************************************************************
+*
+*   raylib example - SIMD image kernels benchmark
+*
+*   Measures the kernels of function_ImageKernels.c on a 4096x4096 R8G8B8A8 image:
+*     - scalar, one thread
+*     - SIMD (AVX2/SSSE3 depending on the build flags), one thread
+*     - SIMD split by row blocks over every core (the Image*() functions)
+*   Throughput is reported in GB/s of pixel data read plus written. Before timing, every
+*   SIMD kernel is checked against its scalar version on odd sized images (tails included).
+*
+*   Build with -mssse3, -mavx2 or -march=native, plain x86-64 builds only get the scalar kernels.
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+
+#include "function_ImageKernels.c"
+
+#define BENCH_WIDTH     4096
+#define BENCH_HEIGHT    4096
+#define BENCH_REPEATS   5
+#define KERNEL_COUNT    6
+
+typedef enum {
+    KERNEL_SWIZZLE = 0,
+    KERNEL_THRESHOLD,
+    KERNEL_ALPHA_FROM_LUMA,
+    KERNEL_PREMULTIPLY,
+    KERNEL_RGB_TO_RGBA,
+    KERNEL_GRAY_ALPHA_TO_RGBA
+} KernelId;
+
+typedef struct KernelBench {
+    const char *name;
+    int srcBytesPerPixel;               // 4 for in place kernels
+    double gbsScalar;
+    double gbsSimd;
+    double gbsThreaded;
+    bool matches;                       // SIMD output equals scalar output
+} KernelBench;
+
+static const unsigned char swizzleOrder[4] = { 2, 1, 0, 3 };
+
+static void RunKernel(KernelId id, bool simd, unsigned char *dst, const unsigned char *src, int count)
+{
+    switch (id)
+    {
+        case KERNEL_SWIZZLE: if (simd) KernelSwizzle(dst, dst, count, swizzleOrder); else KernelSwizzleScalar(dst, dst, count, swizzleOrder); break;
+        case KERNEL_THRESHOLD: if (simd) KernelThreshold(dst, count, 0, 3, 128, 255, 10); else KernelThresholdScalar(dst, count, 0, 3, 128, 255, 10); break;
+        case KERNEL_ALPHA_FROM_LUMA: if (simd) KernelAlphaFromLuma(dst, count); else KernelAlphaFromLumaScalar(dst, count); break;
+        case KERNEL_PREMULTIPLY: if (simd) KernelPremultiply(dst, count); else KernelPremultiplyScalar(dst, count); break;
+        case KERNEL_RGB_TO_RGBA: if (simd) KernelRGBToRGBA(dst, src, count); else KernelRGBToRGBAScalar(dst, src, count); break;
+        case KERNEL_GRAY_ALPHA_TO_RGBA: if (simd) KernelGrayAlphaToRGBA(dst, src, count); else KernelGrayAlphaToRGBAScalar(dst, src, count); break;
+        default: break;
+    }
+}
+
+// Same work through the threaded Image*() functions
+static void RunImageKernel(KernelId id, Image *image, const unsigned char *src)
+{
+    switch (id)
+    {
+        case KERNEL_SWIZZLE: ImageSwizzleChannels(image, 2, 1, 0, 3); break;
+        case KERNEL_THRESHOLD: ImageThresholdChannel(image, 0, 3, 128, 255, 10); break;
+        case KERNEL_ALPHA_FROM_LUMA: ImageAlphaFromLuma(image); break;
+        case KERNEL_PREMULTIPLY: ImagePremultiplyAlpha(image); break;
+        case KERNEL_RGB_TO_RGBA:
+        case KERNEL_GRAY_ALPHA_TO_RGBA:
+        {
+            // conversion writes a new buffer, convert a copy of the source
+            PixelKernelArgs args = { .dst = (unsigned char *)image->data, .src = src, .srcBytesPerPixel = (id == KERNEL_RGB_TO_RGBA)? 3 : 2 };
+            RunPixelKernel(ConvertToRGBATask, &args, image->width, image->height);
+        } break;
+        default: break;
+    }
+}
+
+static void FillRandom(unsigned char *data, size_t size)
+{
+    unsigned int state = 2463534242u;
+    for (size_t i = 0; i < size; i++)
+    {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        data[i] = (unsigned char)state;
+    }
+}
+
+void RunImageKernelBenchmark(KernelBench *bench)
+{
+    const int count = BENCH_WIDTH*BENCH_HEIGHT;
+    unsigned char *src = (unsigned char *)RL_MALLOC((size_t)count*4);
+    unsigned char *dst = (unsigned char *)RL_MALLOC((size_t)count*4);
+    unsigned char *reference = (unsigned char *)RL_MALLOC((size_t)count*4);
+    FillRandom(src, (size_t)count*4);
+
+    Image image = { dst, BENCH_WIDTH, BENCH_HEIGHT, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+    for (int k = 0; k < KERNEL_COUNT; k++)
+    {
+        size_t srcBytes = (size_t)bench[k].srcBytesPerPixel;
+        double bytes = (double)count*(srcBytes + 4);
+
+        // correctness on sizes that leave SIMD tails
+        bench[k].matches = true;
+        for (int n = 1; n < 100; n += 7)
+        {
+            memcpy(dst, src, n*4);
+            memcpy(reference, src, n*4);
+            RunKernel((KernelId)k, true, dst, src, n);
+            RunKernel((KernelId)k, false, reference, src, n);
+            if (memcmp(dst, reference, n*4) != 0) bench[k].matches = false;
+        }
+
+        // best of BENCH_REPEATS for each variant, in place kernels start from the same pixels
+        bench[k].gbsScalar = bench[k].gbsSimd = bench[k].gbsThreaded = 0.0;
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            for (int variant = 0; variant < 3; variant++)
+            {
+                memcpy(dst, src, (size_t)count*4);
+
+                double start = GetTime();
+                if (variant < 2) RunKernel((KernelId)k, (variant == 1), dst, src, count);
+                else RunImageKernel((KernelId)k, &image, src);
+                double gbs = bytes/((GetTime() - start)*1e9);
+
+                double *best = (variant == 0)? &bench[k].gbsScalar : (variant == 1)? &bench[k].gbsSimd : &bench[k].gbsThreaded;
+                if (gbs > *best) *best = gbs;
+
+                if (variant == 0) memcpy(reference, dst, (size_t)count*4);
+                else if (memcmp(dst, reference, (size_t)count*4) != 0) bench[k].matches = false;
+            }
+        }
+
+        printf("KERNELS: %-18s scalar %6.2f GB/s | %s %6.2f GB/s (%4.1fx) | threaded %6.2f GB/s (%4.1fx) | %s\n", bench[k].name,
+            bench[k].gbsScalar, IMAGE_KERNELS_SIMD, bench[k].gbsSimd, bench[k].gbsSimd/bench[k].gbsScalar,
+            bench[k].gbsThreaded, bench[k].gbsThreaded/bench[k].gbsScalar, bench[k].matches? "matches scalar" : "MISMATCH");
+    }
+
+    RL_FREE(reference);
+    RL_FREE(dst);
+    RL_FREE(src);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - SIMD image kernels");
+
+    KernelBench bench[KERNEL_COUNT] = {
+        { .name = "swizzle BGRA", .srcBytesPerPixel = 4 },
+        { .name = "channel threshold", .srcBytesPerPixel = 4 },
+        { .name = "alpha from luma", .srcBytesPerPixel = 4 },
+        { .name = "premultiply", .srcBytesPerPixel = 4 },
+        { .name = "RGB to RGBA", .srcBytesPerPixel = 3 },
+        { .name = "gray alpha to RGBA", .srcBytesPerPixel = 2 },
+    };
+    RunImageKernelBenchmark(bench);
+
+    // The kernels on a real image: alpha from luma then premultiply
+    Image preview = GenImageGradientLinear(256, 256, 45, RED, SKYBLUE);
+    ImageFormatToRGBA8(&preview);
+    ImageAlphaFromLuma(&preview);
+    ImagePremultiplyAlpha(&preview);
+    Texture2D previewTexture = LoadTextureFromImage(preview);
+    UnloadImage(preview);
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyPressed(KEY_SPACE)) RunImageKernelBenchmark(bench);
+        //----------------------------------------------------------------------------------
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(DARKGRAY);
+
+            DrawText(TextFormat("%ix%i R8G8B8A8, GB/s read + written, SPACE to run again", BENCH_WIDTH, BENCH_HEIGHT), 20, 20, 20, LIGHTGRAY);
+            DrawText("kernel", 20, 60, 20, GRAY);
+            DrawText("scalar", 240, 60, 20, GRAY);
+            DrawText(IMAGE_KERNELS_SIMD, 340, 60, 20, GRAY);
+            DrawText("threaded", 440, 60, 20, GRAY);
+            for (int k = 0; k < KERNEL_COUNT; k++)
+            {
+                int y = 90 + k*25;
+                DrawText(bench[k].name, 20, y, 20, bench[k].matches? LIGHTGRAY : RED);
+                DrawText(TextFormat("%.2f", bench[k].gbsScalar), 240, y, 20, LIGHTGRAY);
+                DrawText(TextFormat("%.2f", bench[k].gbsSimd), 340, y, 20, LIGHTGRAY);
+                DrawText(TextFormat("%.2f", bench[k].gbsThreaded), 440, y, 20, GREEN);
+            }
+
+            BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+                DrawTexture(previewTexture, 560, 180, WHITE);
+            EndBlendMode();
+            DrawText("alpha from luma + premultiply", 560, 165, 10, LIGHTGRAY);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadTexture(previewTexture);
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*******************************************************************************************
+*
+*   raylib example - deterministic input record/replay for reproducible benchmark runs
+*
+*   The scene is driven the way the other examples are (orbital camera, mouse picking, key
+*   toggles) but the simulation runs in fixed steps and reads input through
+*   function_InputTrace.c, so a session can be recorded and replayed bit for bit:
+*     record: play normally, every tick's input (mouse position, wheel, buttons and held
+*             keys) goes to the trace, wall frame times are not recorded
+*     replay: no interaction needed, the trace drives one tick per rendered frame with no
+*             frame limiter, frame time statistics are printed when the trace ends
+*   A checksum of the simulation state is printed at the end of both, equal values show the
+*   replay reproduced the recorded run.
+*
+*   Usage: example_input_record_replay [live|record|replay] [trace_file]
+*   Controls: right drag orbit, wheel zoom, left click select, SPACE wireframe, P pause orbit,
+*             1/2/3 grid size
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include "function_InputTrace.c"
+
+#define FIXED_STEP          (1.0f/60.0f)
+#define MAX_GRID            16
+#define MAX_FRAME_SAMPLES   (60*60*10)
+
+typedef struct SceneState {
+    float orbitAngle;
+    float orbitPitch;
+    float distance;
+    bool paused;
+    bool wireframe;
+    int gridSize;
+    int selected;                       // cube index, -1 none
+} SceneState;
+
+static Camera GetSceneCamera(const SceneState *state)
+{
+    Camera camera = { 0 };
+    camera.position = (Vector3){ state->distance*cosf(state->orbitPitch)*cosf(state->orbitAngle),
+                                 state->distance*sinf(state->orbitPitch),
+                                 state->distance*cosf(state->orbitPitch)*sinf(state->orbitAngle) };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return camera;
+}
+
+static Vector3 GetCubePosition(const SceneState *state, int index)
+{
+    int x = index%state->gridSize, z = index/state->gridSize;
+    return (Vector3){ (x - (state->gridSize - 1)*0.5f)*2.0f, 0.0f, (z - (state->gridSize - 1)*0.5f)*2.0f };
+}
+
+// One fixed simulation step, all input from the trace
+static void UpdateScene(SceneState *state, const InputTrace *input)
+{
+    const float dt = input->fixedStep;
+
+    if (TraceIsKeyPressed(input, KEY_SPACE)) state->wireframe = !state->wireframe;
+    if (TraceIsKeyPressed(input, KEY_P)) state->paused = !state->paused;
+    if (TraceIsKeyPressed(input, KEY_ONE)) state->gridSize = 4;
+    if (TraceIsKeyPressed(input, KEY_TWO)) state->gridSize = 8;
+    if (TraceIsKeyPressed(input, KEY_THREE)) state->gridSize = MAX_GRID;
+
+    if (!state->paused) state->orbitAngle += 0.5f*dt;
+    if (TraceIsMouseButtonDown(input, MOUSE_BUTTON_RIGHT))
+    {
+        Vector2 delta = TraceGetMouseDelta(input);
+        state->orbitAngle += delta.x*0.01f;
+        state->orbitPitch = Clamp(state->orbitPitch + delta.y*0.01f, -1.4f, 1.4f);
+    }
+    state->distance = Clamp(state->distance - TraceGetMouseWheelMove(input)*2.0f, 5.0f, 80.0f);
+
+    if (TraceIsMouseButtonPressed(input, MOUSE_BUTTON_LEFT))
+    {
+        Ray ray = GetScreenToWorldRay(TraceGetMousePosition(input), GetSceneCamera(state));
+        float nearest = 1e30f;
+        state->selected = -1;
+
+        for (int i = 0; i < state->gridSize*state->gridSize; i++)
+        {
+            Vector3 p = GetCubePosition(state, i);
+            BoundingBox box = { Vector3SubtractValue(p, 0.5f), Vector3AddValue(p, 0.5f) };
+            RayCollision hit = GetRayCollisionBox(ray, box);
+            if (hit.hit && (hit.distance < nearest))
+            {
+                nearest = hit.distance;
+                state->selected = i;
+            }
+        }
+    }
+}
+
+// FNV-1a over the state, equal for a recorded run and its replay
+static unsigned int GetSceneChecksum(const SceneState *state)
+{
+    const unsigned char *bytes = (const unsigned char *)state;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(SceneState); i++) hash = (hash ^ bytes[i])*16777619u;
+    return hash;
+}
+
+static int CompareFloat(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+    const char *mode = (argc > 1)? argv[1] : "live";
+    const char *traceFile = (argc > 2)? argv[2] : "input_trace.bin";
+
+    InitWindow(screenWidth, screenHeight, "raylib example - input record/replay");
+
+    InputTrace input = { 0 };
+    bool ready = true;
+    if (strcmp(mode, "record") == 0) ready = BeginInputRecording(&input, traceFile, FIXED_STEP);
+    else if (strcmp(mode, "replay") == 0) ready = BeginInputReplay(&input, traceFile);
+    else InitInputTrace(&input, FIXED_STEP);
+
+    if (!ready)
+    {
+        CloseWindow();
+        return 1;
+    }
+
+    // replay runs as fast as it can, one tick per frame
+    SetTargetFPS((input.mode == INPUT_TRACE_REPLAY)? 0 : 60);
+
+    SceneState state;
+    memset(&state, 0, sizeof(SceneState));      // padding included, it goes into the checksum
+    state.orbitPitch = 0.5f;
+    state.distance = 30.0f;
+    state.gridSize = 8;
+    state.selected = -1;
+    float accumulator = 0.0f;
+    bool traceEnded = false;
+
+    const char *modeText[3] = { "LIVE", "RECORDING", "REPLAY" };
+    const InputTraceMode traceMode = input.mode;
+
+    static float frameTimes[MAX_FRAME_SAMPLES] = { 0 };
+    int frameCount = 0;
+    double start = GetTime();
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!traceEnded && !WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        BeginInputTraceFrame(&input);
+
+        if (input.mode == INPUT_TRACE_REPLAY)
+        {
+            if (StepInputTrace(&input)) UpdateScene(&state, &input);
+            else traceEnded = true;
+        }
+        else
+        {
+            for (accumulator += GetFrameTime(); accumulator >= input.fixedStep; accumulator -= input.fixedStep)
+            {
+                StepInputTrace(&input);
+                UpdateScene(&state, &input);
+            }
+        }
+
+        if (frameCount < MAX_FRAME_SAMPLES) frameTimes[frameCount++] = GetFrameTime();
+        //----------------------------------------------------------------------------------
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        Camera camera = GetSceneCamera(&state);
+
+        BeginDrawing();
+
+            ClearBackground(RAYWHITE);
+
+            BeginMode3D(camera);
+
+                for (int i = 0; i < state.gridSize*state.gridSize; i++)
+                {
+                    Vector3 p = GetCubePosition(&state, i);
+                    Color color = (i == state.selected)? ORANGE : ColorFromHSV(360.0f*i/(state.gridSize*state.gridSize), 0.6f, 0.9f);
+                    if (state.wireframe) DrawCubeWires(p, 1.0f, 1.0f, 1.0f, color);
+                    else DrawCube(p, 1.0f, 1.0f, 1.0f, color);
+                }
+                DrawGrid(MAX_GRID*2, 1.0f);
+
+            EndMode3D();
+
+            DrawText(TextFormat("%s  tick %i  state %08X", modeText[input.mode], input.tick, GetSceneChecksum(&state)), 10, 10, 20, MAROON);
+            DrawFPS(10, 40);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    double elapsed = GetTime() - start;
+    EndInputTrace(&input);
+    CloseWindow();        // Close window and OpenGL context
+
+    // Frame time statistics, the first frame is skipped (window creation)
+    if (frameCount > 1)
+    {
+        qsort(frameTimes + 1, frameCount - 1, sizeof(float), CompareFloat);
+        double sum = 0.0;
+        for (int i = 1; i < frameCount; i++) sum += frameTimes[i];
+        int n = frameCount - 1;
+
+        printf("INPUT: %s, %i ticks, %i frames in %.2f s: frame time avg %.3f ms, min %.3f ms, median %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            modeText[traceMode], input.tick, frameCount, elapsed, sum/n*1000.0, frameTimes[1]*1000.0f,
+            frameTimes[1 + n/2]*1000.0f, frameTimes[1 + (n - 1)*99/100]*1000.0f, frameTimes[frameCount - 1]*1000.0f);
+    }
+    printf("INPUT: final state checksum %08X\n", GetSceneChecksum(&state));
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
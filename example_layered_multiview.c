@@ -0,0 +1,383 @@
+/*******************************************************************************************
+*
+*   raylib example - layered multi-view rendering, the scene is submitted once for all views
+*
+*   Split screen and multi-camera setups usually draw the whole scene once per view.
+*   Here a geometry shader broadcasts every triangle to all views instead, reading the
+*   per-view matrices from a uniform buffer:
+*     - viewport mode: gl_ViewportIndex selects one of N viewports of the same framebuffer
+*       (needs GL_ARB_viewport_array / GL 4.1)
+*     - layer mode: gl_Layer selects one layer of a 2D texture array framebuffer, the
+*       layers are then blitted to the screen (works on any GL 3.3 driver)
+*     - per view mode: the old way, the scene is drawn once per view, for comparison
+*
+*   Press SPACE to cycle modes.
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "external/glad.h"
+#include "rlgl.h"
+#define GLFW_INCLUDE_NONE
+#include <external/glfw/include/GLFW/glfw3.h>      // Required for: glfwExtensionSupported()
+
+#define MAX_VIEWS           4
+#define NUM_OBJECTS         400
+#define VIEW_UBO_BINDING    0
+
+typedef enum {
+    MODE_PER_VIEW = 0,
+    MODE_VIEWPORT_INDEX,
+    MODE_LAYER,
+    MODE_COUNT
+} MultiViewMode;
+
+const char *modeNames[MODE_COUNT] = { "per view submission", "gl_ViewportIndex, single submission", "gl_Layer, single submission" };
+
+//----------------------------------------------------------------------------------
+// Shaders
+//----------------------------------------------------------------------------------
+const char* vertexShaderSrc=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"in vec3 vertexNormal;\n"
+"uniform mat4 matModel;\n"
+"out vec3 vNormal;\n"
+"void main()\n"
+"{\n"
+"    vNormal = normalize(mat3(matModel)*vertexNormal);\n"
+"    gl_Position = matModel*vec4(vertexPosition, 1.0);\n"     // world space, projected per view in the GS
+"}\n";
+
+// headers select how the view is output, the body is shared
+const char* geometryShaderViewportHeader=
+"#version 330\n"
+"#extension GL_ARB_viewport_array : require\n"
+"#define SET_VIEW(i) gl_ViewportIndex = i\n";
+
+const char* geometryShaderLayerHeader=
+"#version 330\n"
+"#define SET_VIEW(i) gl_Layer = i\n";
+
+const char* geometryShaderBody=
+"#define MAX_VIEWS 4\n"
+"layout(triangles) in;\n"
+"layout(triangle_strip, max_vertices = 12) out;\n"      // 3*MAX_VIEWS
+"layout(std140) uniform ViewMatrices\n"
+"{\n"
+"    mat4 viewProj[MAX_VIEWS];\n"
+"};\n"
+"uniform int viewCount;\n"
+"in vec3 vNormal[];\n"
+"out vec3 fragNormal;\n"
+"void main()\n"
+"{\n"
+"    for (int v = 0; v < viewCount; v++)\n"
+"    {\n"
+"        for (int i = 0; i < 3; i++)\n"
+"        {\n"
+"            gl_Position = viewProj[v]*gl_in[i].gl_Position;\n"
+"            fragNormal = vNormal[i];\n"
+"            SET_VIEW(v);\n"
+"            EmitVertex();\n"
+"        }\n"
+"        EndPrimitive();\n"
+"    }\n"
+"}\n";
+
+const char* fragmentShaderSrc=
+"#version 330\n"
+"in vec3 fragNormal;\n"
+"uniform vec4 colDiffuse;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    float light = 0.3 + 0.7*max(dot(normalize(fragNormal), normalize(vec3(0.4, 1.0, 0.3))), 0.0);\n"
+"    finalColor = vec4(colDiffuse.rgb*light, 1.0);\n"
+"}\n";
+
+// Compile one shader stage from a header and a body string, returns 0 on failure
+static unsigned int CompileShaderStage(const char *header, const char *body, int type)
+{
+    const char *sources[2] = { header, body };
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, (body != NULL)? 2 : 1, sources, NULL);
+    glCompileShader(shader);
+
+    GLint success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        printf("SHADER: [ID %i] Compile error: %s\n", shader, log);
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+// Load the broadcast program, geometry shader output selected by gsHeader
+// NOTE: returns a shader with id 0 on failure
+Shader LoadMultiViewShader(const char *gsHeader)
+{
+    Shader shader = { 0 };
+
+    unsigned int vs = CompileShaderStage(vertexShaderSrc, NULL, GL_VERTEX_SHADER);
+    unsigned int gs = CompileShaderStage(gsHeader, geometryShaderBody, GL_GEOMETRY_SHADER);
+    unsigned int fs = CompileShaderStage(fragmentShaderSrc, NULL, GL_FRAGMENT_SHADER);
+
+    if ((vs > 0) && (gs > 0) && (fs > 0))
+    {
+        shader.id = glCreateProgram();
+        glAttachShader(shader.id, vs);
+        glAttachShader(shader.id, gs);
+        glAttachShader(shader.id, fs);
+        glBindAttribLocation(shader.id, 0, "vertexPosition");
+        glBindAttribLocation(shader.id, 2, "vertexNormal");
+        glLinkProgram(shader.id);
+
+        GLint success = 0;
+        glGetProgramiv(shader.id, GL_LINK_STATUS, &success);
+        if (success == GL_FALSE)
+        {
+            char log[1024];
+            glGetProgramInfoLog(shader.id, sizeof(log), NULL, log);
+            printf("SHADER: [ID %i] Link error: %s\n", shader.id, log);
+            glDeleteProgram(shader.id);
+            shader.id = 0;
+        }
+    }
+
+    if (vs > 0) glDeleteShader(vs);
+    if (gs > 0) glDeleteShader(gs);
+    if (fs > 0) glDeleteShader(fs);
+
+    if (shader.id > 0)
+    {
+        shader.locs = (int *)RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int));
+        for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+        shader.locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader.id, "vertexPosition");
+        shader.locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(shader.id, "vertexNormal");
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(shader.id, "matModel");
+        shader.locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader.id, "colDiffuse");
+
+        glUniformBlockBinding(shader.id, glGetUniformBlockIndex(shader.id, "ViewMatrices"), VIEW_UBO_BINDING);
+    }
+
+    return shader;
+}
+
+// Upload view-projection matrices (column major, as GLSL expects) to the views UBO
+void UpdateViewMatrices(unsigned int ubo, const Matrix *viewProj, int count)
+{
+    float data[MAX_VIEWS*16];
+    for (int i = 0; i < count; i++)
+    {
+        float16 m = MatrixToFloatV(viewProj[i]);
+        for (int j = 0; j < 16; j++) data[i*16 + j] = m.v[j];
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count*16*sizeof(float), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+    const int viewWidth = screenWidth/2;
+    const int viewHeight = screenHeight/2;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - layered multi-view rendering");
+
+    bool viewportArray = glfwExtensionSupported("GL_ARB_viewport_array");
+    Shader viewportShader = { 0 };
+    if (viewportArray) viewportShader = LoadMultiViewShader(geometryShaderViewportHeader);
+    Shader layerShader = LoadMultiViewShader(geometryShaderLayerHeader);   // also used for per view mode, gl_Layer is ignored on the default framebuffer
+    int viewCountLocViewport = (viewportShader.id > 0)? GetShaderLocation(viewportShader, "viewCount") : -1;
+    int viewCountLocLayer = GetShaderLocation(layerShader, "viewCount");
+
+    unsigned int ubo = 0;
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, MAX_VIEWS*16*sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, VIEW_UBO_BINDING, ubo);
+
+    // layered framebuffer: one colour and depth layer per view
+    unsigned int layerColor = 0, layerDepth = 0, layerFbo = 0, readFbo = 0;
+    glGenTextures(1, &layerColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, layerColor);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, viewWidth, viewHeight, MAX_VIEWS, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glGenTextures(1, &layerDepth);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, layerDepth);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, viewWidth, viewHeight, MAX_VIEWS, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &layerFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, layerFbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, layerColor, 0);     // all layers attached
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, layerDepth, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) TRACELOG(LOG_WARNING, "FBO: [ID %i] Layered framebuffer is not complete", layerFbo);
+    glGenFramebuffers(1, &readFbo);     // one layer at a time is attached here to blit it
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // scene
+    Mesh cube = GenMeshCube(1.0f, 1.0f, 1.0f);
+    Matrix transforms[NUM_OBJECTS];
+    Color colors[NUM_OBJECTS];
+    for (int i = 0; i < NUM_OBJECTS; i++)
+    {
+        transforms[i] = MatrixTranslate((float)GetRandomValue(-20, 20), (float)GetRandomValue(0, 6), (float)GetRandomValue(-20, 20));
+        colors[i] = (Color){ GetRandomValue(60, 255), GetRandomValue(60, 255), GetRandomValue(60, 255), 255 };
+    }
+    Material material = LoadMaterialDefault();
+
+    MultiViewMode mode = viewportArray? MODE_VIEWPORT_INDEX : MODE_LAYER;
+    double submitMs = 0;
+    int drawCalls = 0;
+
+    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyPressed(KEY_SPACE))
+        {
+            mode = (mode + 1)%MODE_COUNT;
+            if ((mode == MODE_VIEWPORT_INDEX) && (viewportShader.id == 0)) mode = (mode + 1)%MODE_COUNT;
+        }
+
+        // four cameras around the scene
+        Matrix viewProj[MAX_VIEWS];
+        float t = (float)GetTime()*0.2f;
+        for (int v = 0; v < MAX_VIEWS; v++)
+        {
+            float angle = t + v*PI/2.0f;
+            Matrix view = MatrixLookAt((Vector3){ cosf(angle)*30.0f, 15.0f + v*3.0f, sinf(angle)*30.0f }, (Vector3){ 0, 0, 0 }, (Vector3){ 0, 1, 0 });
+            Matrix proj = MatrixPerspective(45.0*DEG2RAD, (double)viewWidth/viewHeight, 0.1, 200.0);
+            viewProj[v] = MatrixMultiply(view, proj);
+        }
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+            ClearBackground(DARKGRAY);
+            rlDrawRenderBatchActive();
+            rlEnableDepthTest();
+
+            double start = GetTime();
+            drawCalls = 0;
+
+            if (mode == MODE_PER_VIEW)
+            {
+                // the scene is submitted once per view
+                material.shader = layerShader;
+                int one = 1;
+                SetShaderValue(layerShader, viewCountLocLayer, &one, SHADER_UNIFORM_INT);
+                for (int v = 0; v < MAX_VIEWS; v++)
+                {
+                    UpdateViewMatrices(ubo, &viewProj[v], 1);
+                    glViewport((v%2)*viewWidth, (1 - v/2)*viewHeight, viewWidth, viewHeight);
+                    for (int i = 0; i < NUM_OBJECTS; i++)
+                    {
+                        material.maps[MATERIAL_MAP_DIFFUSE].color = colors[i];
+                        DrawMesh(cube, material, transforms[i]);
+                        drawCalls++;
+                    }
+                }
+            }
+            else if (mode == MODE_VIEWPORT_INDEX)
+            {
+                for (int v = 0; v < MAX_VIEWS; v++) glViewportIndexedf(v, (float)((v%2)*viewWidth), (float)((1 - v/2)*viewHeight), (float)viewWidth, (float)viewHeight);
+
+                material.shader = viewportShader;
+                int count = MAX_VIEWS;
+                SetShaderValue(viewportShader, viewCountLocViewport, &count, SHADER_UNIFORM_INT);
+                UpdateViewMatrices(ubo, viewProj, MAX_VIEWS);
+                for (int i = 0; i < NUM_OBJECTS; i++)
+                {
+                    material.maps[MATERIAL_MAP_DIFFUSE].color = colors[i];
+                    DrawMesh(cube, material, transforms[i]);
+                    drawCalls++;
+                }
+            }
+            else
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, layerFbo);
+                glViewport(0, 0, viewWidth, viewHeight);
+                glClearColor(0.3f, 0.3f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);     // clears every layer
+
+                material.shader = layerShader;
+                int count = MAX_VIEWS;
+                SetShaderValue(layerShader, viewCountLocLayer, &count, SHADER_UNIFORM_INT);
+                UpdateViewMatrices(ubo, viewProj, MAX_VIEWS);
+                for (int i = 0; i < NUM_OBJECTS; i++)
+                {
+                    material.maps[MATERIAL_MAP_DIFFUSE].color = colors[i];
+                    DrawMesh(cube, material, transforms[i]);
+                    drawCalls++;
+                }
+
+                // copy each layer to its quadrant of the screen
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+                for (int v = 0; v < MAX_VIEWS; v++)
+                {
+                    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, layerColor, 0, v);
+                    int x = (v%2)*viewWidth, y = (1 - v/2)*viewHeight;
+                    glBlitFramebuffer(0, 0, viewWidth, viewHeight, x, y, x + viewWidth, y + viewHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                }
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            }
+
+            submitMs = (GetTime() - start)*1000.0;
+
+            // back to raylib's state for 2D drawing
+            glViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+            rlDisableDepthTest();
+
+            DrawLine(viewWidth, 0, viewWidth, screenHeight, BLACK);
+            DrawLine(0, viewHeight, screenWidth, viewHeight, BLACK);
+            DrawText(TextFormat("Mode: %s (SPACE)", modeNames[mode]), 10, 30, 20, WHITE);
+            DrawText(TextFormat("%i draw calls, %.2f ms CPU submission%s", drawCalls, submitMs, viewportArray? "" : ", GL_ARB_viewport_array not available"), 10, 55, 10, WHITE);
+            DrawFPS(10, 10);
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    material.shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+    UnloadMaterial(material);
+    UnloadMesh(cube);
+    if (viewportShader.id > 0) UnloadShader(viewportShader);
+    UnloadShader(layerShader);
+    glDeleteBuffers(1, &ubo);
+    glDeleteFramebuffers(1, &layerFbo);
+    glDeleteFramebuffers(1, &readFbo);
+    glDeleteTextures(1, &layerColor);
+    glDeleteTextures(1, &layerDepth);
+
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
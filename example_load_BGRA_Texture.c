@@ -1,13 +1,33 @@
 /*******************************************************************************************
 *
 * Example of loading a BGRA texture
-* 
+*
+* Two ways to get BGRA pixels on the GPU:
+*   - LoadTextureBGRA(): swaps R and B on the CPU, one pixel at a time, then uploads
+*   - LoadTextureBGRAZeroCopy(): uploads the original bytes, the GPU does the swap, either
+*       by GL_BGRA as external format (desktop GL, GLES2 with EXT_texture_format_BGRA8888)
+*       or by a texture swizzle (GLES3), no CPU pass over the pixels at all
+* UpdateTextureBGRA() does the same for textures updated every frame (video or camera frames),
+* the benchmark at the bottom uploads 1080p BGRA frames through each path.
 *
 ********************************************************************************************/
 #include <stdlib.h>
 #include "raylib.h"
 #include "rlgl.h"
 #include "external/glad.h"
+#include <external/glfw/include/GLFW/glfw3.h>      // Required for: glfwExtensionSupported()
+
+#include "function_ImageKernels.c"
+
+#define VIDEO_WIDTH     1920
+#define VIDEO_HEIGHT    1080
+#define VIDEO_FRAMES    4
+
+typedef enum {
+    BGRA_UPLOAD_CPU_SWAP = 0,           // swap R and B on the CPU, upload as RGBA
+    BGRA_UPLOAD_GL_FORMAT,              // GL_BGRA/GL_BGR external format
+    BGRA_UPLOAD_SWIZZLE                 // upload as RGBA, texture swizzle swaps R and B when sampling
+} BGRAUploadPath;
 
 //------------------------------------------------------------------------------------
 // Texture loading functions
@@ -29,7 +49,7 @@ Texture2D LoadTextureBGRA(const char *fileName)
         {
         UnloadImage(image);
         TRACELOG(LOG_ERROR, "Format of the image %s not supported.", fileName);
-        return texture;    
+        return texture;
         }
 
     if (image.data != NULL)
@@ -48,6 +68,132 @@ Texture2D LoadTextureBGRA(const char *fileName)
     return texture;
 }
 
+// Best path the current context supports for comp channels (3 or 4)
+BGRAUploadPath GetBGRAUploadPath(int comp)
+{
+    int version = rlGetVersion();
+
+    if ((version == RL_OPENGL_21) || (version == RL_OPENGL_33) || (version == RL_OPENGL_43)) return BGRA_UPLOAD_GL_FORMAT;    // core since GL 1.2
+    if ((comp == 4) && glfwExtensionSupported("GL_EXT_texture_format_BGRA8888")) return BGRA_UPLOAD_GL_FORMAT;               // GLES: no GL_BGR
+    if (version == RL_OPENGL_ES_30) return BGRA_UPLOAD_SWIZZLE;
+
+    return BGRA_UPLOAD_CPU_SWAP;
+}
+
+// Upload BGRA (comp = 4) or BGR (comp = 3) pixels to a texture, or to a new texture if texture->id is 0
+// NOTE: scratch (width*height*comp bytes) is only used by BGRA_UPLOAD_CPU_SWAP, data is never modified
+static void UploadTextureBGRA(Texture2D *texture, const void *data, int width, int height, int comp, BGRAUploadPath path, unsigned char *scratch)
+{
+    bool es = (rlGetVersion() == RL_OPENGL_ES_20) || (rlGetVersion() == RL_OPENGL_ES_30);
+    GLenum externalFormat = (comp == 4)? GL_RGBA : GL_RGB;
+    GLenum internalFormat = (comp == 4)? GL_RGBA8 : GL_RGB8;
+
+    // OpenGL ES 2.0 only takes unsized internal formats (equal to the external one)
+    if (es && (path == BGRA_UPLOAD_CPU_SWAP)) internalFormat = externalFormat;
+
+    if ((path == BGRA_UPLOAD_CPU_SWAP) && (data != NULL))
+    {
+        static const unsigned char order[4] = { 2, 1, 0, 3 };
+        const unsigned char *src = (const unsigned char *)data;
+
+        if (comp == 4) KernelSwizzle(scratch, src, width*height, order);
+        else
+        {
+            int size = width*height*3;
+            for (int i = 0; i < size; i += 3)
+            {
+                scratch[i] = src[i + 2];
+                scratch[i + 1] = src[i + 1];
+                scratch[i + 2] = src[i];
+            }
+        }
+        data = scratch;
+    }
+    else if (path == BGRA_UPLOAD_GL_FORMAT)
+    {
+        externalFormat = (comp == 4)? GL_BGRA : GL_BGR;
+        if (es) internalFormat = GL_BGRA;       // EXT_texture_format_BGRA8888: internal format must match
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (texture->id == 0)
+    {
+        glGenTextures(1, &texture->id);
+        glBindTexture(GL_TEXTURE_2D, texture->id);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, externalFormat, GL_UNSIGNED_BYTE, data);
+
+        // same defaults as rlLoadTexture()
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+        if (path == BGRA_UPLOAD_SWIZZLE)
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_BLUE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+        }
+
+        texture->width = width;
+        texture->height = height;
+        texture->mipmaps = 1;
+        texture->format = (comp == 4)? PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 : PIXELFORMAT_UNCOMPRESSED_R8G8B8;
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, texture->id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, externalFormat, GL_UNSIGNED_BYTE, data);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Load texture from file into GPU memory (VRAM), the file's bytes are uploaded as they are and read as BGRA
+// NOTE: same result as LoadTextureBGRA() without the CPU pass over the pixels (when the context supports it)
+Texture2D LoadTextureBGRAZeroCopy(const char *fileName)
+{
+    Texture2D texture = { 0 };
+
+    Image image = LoadImage(fileName);
+
+    int comp = 0;
+    if (image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) comp = 3;
+    if (image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) comp = 4;
+
+    if ((comp == 0) || (image.data == NULL))
+    {
+        UnloadImage(image);
+        TRACELOG(LOG_ERROR, "Format of the image %s not supported.", fileName);
+        return texture;
+    }
+
+    BGRAUploadPath path = GetBGRAUploadPath(comp);
+    unsigned char *scratch = NULL;
+    if (path == BGRA_UPLOAD_CPU_SWAP) scratch = (unsigned char *)RL_MALLOC(image.width*image.height*comp);
+
+    UploadTextureBGRA(&texture, image.data, image.width, image.height, comp, path, scratch);
+
+    RL_FREE(scratch);
+    UnloadImage(image);
+    return texture;
+}
+
+// Create a texture for BGRA frames of the given size, fill it with UpdateTextureBGRA()
+Texture2D LoadTextureBGRAEmpty(int width, int height, BGRAUploadPath path)
+{
+    Texture2D texture = { 0 };
+    UploadTextureBGRA(&texture, NULL, width, height, 4, path, NULL);
+    return texture;
+}
+
+// Replace the contents of a texture created by LoadTextureBGRAEmpty() with a new BGRA frame
+// NOTE: path must be the one the texture was created with, scratch only needed for BGRA_UPLOAD_CPU_SWAP
+void UpdateTextureBGRA(Texture2D texture, const void *pixels, BGRAUploadPath path, unsigned char *scratch)
+{
+    UploadTextureBGRA(&texture, pixels, texture.width, texture.height, 4, path, scratch);
+}
+
 
 //------------------------------------------------------------------------------------
 // Program main entry point
@@ -61,14 +207,60 @@ int main(void)
 
     InitWindow(screenWidth, screenHeight, "raylib example");
 
+    BGRAUploadPath bestPath = GetBGRAUploadPath(4);
+    const char *pathNames[3] = { "CPU swap", "GL_BGRA format", "texture swizzle" };
+
     Texture2D rgba_tex=LoadTexture("resources/parrots.png");
     Texture2D bgra_tex=LoadTextureBGRA("resources/parrots.png");
+    Texture2D bgra_zero_copy_tex=LoadTextureBGRAZeroCopy("resources/parrots.png");
+
+    // Video frames arriving as BGRA, one streaming texture per upload path
+    unsigned char *frames = (unsigned char *)RL_MALLOC(VIDEO_FRAMES*VIDEO_WIDTH*VIDEO_HEIGHT*4);
+    unsigned char *scratch = (unsigned char *)RL_MALLOC(VIDEO_WIDTH*VIDEO_HEIGHT*4);
+    for (int f = 0; f < VIDEO_FRAMES; f++)
+    {
+        unsigned char *frame = frames + (size_t)f*VIDEO_WIDTH*VIDEO_HEIGHT*4;
+        for (int y = 0; y < VIDEO_HEIGHT; y++)
+        {
+            for (int x = 0; x < VIDEO_WIDTH; x++)
+            {
+                unsigned char *p = frame + ((size_t)y*VIDEO_WIDTH + x)*4;
+                p[0] = (unsigned char)(x + f*32);       // B
+                p[1] = (unsigned char)(y);              // G
+                p[2] = (unsigned char)(255 - x/8);      // R
+                p[3] = 255;
+            }
+        }
+    }
 
-    SetTargetFPS(10);
+    int version = rlGetVersion();
+    bool available[3] = { true, (bestPath == BGRA_UPLOAD_GL_FORMAT),
+        (version == RL_OPENGL_33) || (version == RL_OPENGL_43) || (version == RL_OPENGL_ES_30) };     // swizzle: GL 3.3, GLES 3.0
+    int videoPath = bestPath;
+    Texture2D videoTextures[3] = { 0 };
+    for (int p = 0; p < 3; p++) if (available[p]) videoTextures[p] = LoadTextureBGRAEmpty(VIDEO_WIDTH, VIDEO_HEIGHT, (BGRAUploadPath)p);
+
+    double uploadMs[3] = { 0 };
+    int frameCounter = 0;
+
+    SetTargetFPS(60);
     while (!WindowShouldClose())
         {
+        // Upload one video frame through the selected path, timed including the GPU side
+        if (IsKeyPressed(KEY_V)) do videoPath = (videoPath + 1)%3; while (!available[videoPath]);
+
+        glFinish();
+        double start = GetTime();
+        UpdateTextureBGRA(videoTextures[videoPath], frames + (size_t)(frameCounter%VIDEO_FRAMES)*VIDEO_WIDTH*VIDEO_HEIGHT*4, (BGRAUploadPath)videoPath, scratch);
+        glFinish();
+        double ms = (GetTime() - start)*1000.0;
+        uploadMs[videoPath] = (uploadMs[videoPath] == 0.0)? ms : uploadMs[videoPath]*0.95 + ms*0.05;
+        frameCounter++;
+
         BeginDrawing();
-        ClearBackground(BLACK);    
+        ClearBackground(BLACK);
+
+        DrawTexturePro(videoTextures[videoPath], (Rectangle){ 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT }, (Rectangle){ 0, 0, screenWidth, screenHeight }, (Vector2){ 0, 0 }, 0.0f, WHITE);
 
         if (IsKeyDown(KEY_ONE))
             DrawTexture(rgba_tex,0,0,WHITE);
@@ -76,16 +268,30 @@ int main(void)
         if (IsKeyDown(KEY_TWO))
             DrawTexture(bgra_tex,0,0,WHITE);
 
+        if (IsKeyDown(KEY_THREE))
+            DrawTexture(bgra_zero_copy_tex,0,0,WHITE);
+
         DrawText("Hold pressed key 1 to show RGBA texture 1",0,0,20,WHITE);
-        DrawText("Hold pressed key 2 to show BGRA texture 2",0,20,20,WHITE);
+        DrawText("Hold pressed key 2 to show BGRA texture 2 (CPU swap)",0,20,20,WHITE);
+        DrawText(TextFormat("Hold pressed key 3 to show BGRA texture 3 (%s)", pathNames[bestPath]),0,40,20,WHITE);
+        DrawText(TextFormat("Press V to change the video upload path, now: %s", pathNames[videoPath]),0,70,20,YELLOW);
+        for (int p = 0; p < 3; p++)
+            if (available[p]) DrawText(TextFormat("%-16s %6.2f ms/frame  %5.2f GB/s", pathNames[p], uploadMs[p],
+                (uploadMs[p] > 0.0)? VIDEO_WIDTH*VIDEO_HEIGHT*4/(uploadMs[p]*1e6) : 0.0),0,100 + p*20,20,(p == videoPath)? YELLOW : LIGHTGRAY);
 
-        EndDrawing();    
+        EndDrawing();
         }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    for (int p = 0; p < 3; p++) if (available[p]) UnloadTexture(videoTextures[p]);
+    UnloadTexture(bgra_zero_copy_tex);
+    UnloadTexture(bgra_tex);
+    UnloadTexture(rgba_tex);
+    RL_FREE(scratch);
+    RL_FREE(frames);
+
     CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     return 0;
 }
-
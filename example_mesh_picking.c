@@ -1,8 +1,14 @@
 /*******************************************************************************************
 *   screen space mesh picking / using "occlusion queries" or "color picking"
 *   OpenGL queries code taken from: https://stackoverflow.com/questions/36258142/opengl-c-occlusion-query
+*
+*   selected objects are drawn once with a highlight shader: a geometry shader gives every
+*   triangle corner a barycentric coordinate and the fragment shader blends anti-aliased
+*   white edges over the fill color (press W to compare with the old two pass wire mode)
 *   
 ********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
 #include "raylib.h"
 #include "raymath.h"
 #include "rlgl.h"
@@ -37,6 +43,86 @@ RenderTexture2D rt;        // our "work" render texture
 
 unsigned int query[1], numSamplesRendered; // OpenGL variables
 
+char wire_mode_highlight = 0; // 1 = draw selection highlight with rlEnableWireMode() in a second pass
+
+const char* highlightShader_vs=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"uniform mat4 mvp;\n"
+"void main()\n"
+"{\n"
+"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+"}\n";
+
+const char* highlightShader_gs=
+"#version 330\n"
+"layout(triangles) in;\n"
+"layout(triangle_strip, max_vertices = 3) out;\n"
+"out vec3 barycentric;\n"
+"void main()\n"
+"{\n"
+"    gl_Position = gl_in[0].gl_Position; barycentric = vec3(1.0, 0.0, 0.0); EmitVertex();\n"
+"    gl_Position = gl_in[1].gl_Position; barycentric = vec3(0.0, 1.0, 0.0); EmitVertex();\n"
+"    gl_Position = gl_in[2].gl_Position; barycentric = vec3(0.0, 0.0, 1.0); EmitVertex();\n"
+"    EndPrimitive();\n"
+"}\n";
+
+const char* highlightShader_fs=
+"#version 330\n"
+"in vec3 barycentric;\n"
+"uniform vec4 colDiffuse;\n"
+"uniform vec4 edgeColor;\n"
+"uniform float edgeWidth;\n"       // in pixels
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    // distance to the closest edge in pixels, fwidth() keeps the width constant on screen\n"
+"    vec3 d = barycentric/fwidth(barycentric);\n"
+"    float edge = 1.0 - smoothstep(edgeWidth - 1.0, edgeWidth, min(min(d.x, d.y), d.z));\n"
+"    finalColor = mix(colDiffuse, edgeColor, edge);\n"
+"}\n";
+
+// Compile and link a vertex + geometry + fragment program, returns 0 on failure
+unsigned int LoadHighlightProgram(void)
+{
+    const char *sources[3] = { highlightShader_vs, highlightShader_gs, highlightShader_fs };
+    const GLenum types[3] = { GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+    unsigned int stages[3] = { 0 };
+    char log[1024];
+    GLint success = 0;
+
+    unsigned int id = glCreateProgram();
+    for (int i = 0; i < 3; i++)
+        {
+        stages[i] = glCreateShader(types[i]);
+        glShaderSource(stages[i], 1, &sources[i], NULL);
+        glCompileShader(stages[i]);
+        glGetShaderiv(stages[i], GL_COMPILE_STATUS, &success);
+        if (success == GL_FALSE)
+            {
+            glGetShaderInfoLog(stages[i], sizeof(log), NULL, log);
+            printf("SHADER: [ID %i] Compile error: %s\n", stages[i], log);
+            }
+        glAttachShader(id, stages[i]);
+        }
+
+    glBindAttribLocation(id, 0, "vertexPosition");
+    glLinkProgram(id);
+
+    for (int i = 0; i < 3; i++) { glDetachShader(id, stages[i]); glDeleteShader(stages[i]); }
+
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+        {
+        glGetProgramInfoLog(id, sizeof(log), NULL, log);
+        printf("SHADER: [ID %i] Link error: %s\n", id, log);
+        glDeleteProgram(id);
+        id = 0;
+        }
+
+    return id;
+}
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
@@ -82,6 +168,27 @@ int main(void)
 
     Material material = LoadMaterialDefault();
 
+    // selection highlight: fill and edges in a single draw
+    Material highlight = LoadMaterialDefault();
+    unsigned int highlight_program = LoadHighlightProgram();
+    if (highlight_program > 0)
+        {
+        Shader shader = { 0 };
+        shader.id = highlight_program;
+        shader.locs = (int *)RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int));
+        for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+        shader.locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader.id, "vertexPosition");
+        shader.locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(shader.id, "mvp");
+        shader.locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader.id, "colDiffuse");
+
+        Vector4 edge_color = { 1.0f, 1.0f, 1.0f, 1.0f };
+        float edge_width = 1.5f;
+        SetShaderValue(shader, GetShaderLocation(shader, "edgeColor"), &edge_color, SHADER_UNIFORM_VEC4);
+        SetShaderValue(shader, GetShaderLocation(shader, "edgeWidth"), &edge_width, SHADER_UNIFORM_FLOAT);
+        highlight.shader = shader;
+        }
+    else wire_mode_highlight = 1;   // no geometry shader support, fall back to wire mode
+
     box_select=0;
     selection_method=1;
 
@@ -98,6 +205,7 @@ int main(void)
         //----------------------------------------------------------------------------------
         if (IsKeyDown(KEY_ONE)) selection_method=1;
         if (IsKeyDown(KEY_TWO)) selection_method=2;
+        if (IsKeyPressed(KEY_W) && highlight_program > 0) wire_mode_highlight=!wire_mode_highlight;
 
         // init mouse box selection
         if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && box_select==0)
@@ -205,6 +313,14 @@ int main(void)
 
             for (int i=0;i<MAX_OBJECTS;i++)
                 {
+                if (objects[i].selected && !wire_mode_highlight)
+                    {
+                    // single pass: fill and anti-aliased edges
+                    highlight.maps[MATERIAL_MAP_DIFFUSE].color = objects[i].color;
+                    DrawMesh(objects[i].mesh,highlight,objects[i].transform);
+                    continue;
+                    }
+
                 material.maps[MATERIAL_MAP_DIFFUSE].color = objects[i].color;
                 DrawMesh(objects[i].mesh,material,objects[i].transform);
 
@@ -229,6 +345,7 @@ int main(void)
 
         DrawText("Press 1 to use selection box and OpenGL occlusion queries (click and drag to select)",10,30,10,WHITE);
         DrawText("Press 2 to use color picking (hover mouse over an object)",10,50,10,WHITE);
+        DrawText(TextFormat("Press W to toggle selection highlight: %s", wire_mode_highlight? "wire mode, 2 draws" : "barycentric edges, 1 draw"),10,70,10,WHITE);
 
         EndDrawing();
         //----------------------------------------------------------------------------------
@@ -240,6 +357,7 @@ int main(void)
         }
     
     glDeleteQueries(1, query);
+    UnloadMaterial(highlight);  // also unloads the highlight shader
 
      CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
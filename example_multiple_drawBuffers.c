@@ -131,6 +131,17 @@ int main(void)
     // used to visualize one selected draw buffer from shader
     int selectTexLoc = GetShaderLocation(shader_display, "tex_select");
 
+    // link our shader's samplers to the correct OpenGL texture unit
+    // NOTE: sampler uniforms keep their value in the program, so this is done once and not every frame
+    rlEnableShader(shader_display.id);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color0Tex"), 0);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color1Tex"), 1);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color2Tex"), 2);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color3Tex"), 3);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color4Tex"), 4);
+    glUniform1i(rlGetLocationUniform(shader_display.id, "color5Tex"), 5);
+    rlDisableShader();
+
     // Initialize the G-buffer
     GBuffer gBuffer = { 0 };
     gBuffer.framebuffer = rlLoadFramebuffer();
@@ -260,14 +271,6 @@ int main(void)
         rlActiveTextureSlot(4);        rlEnableTexture(gBuffer.color4_attach);
         rlActiveTextureSlot(5);        rlEnableTexture(gBuffer.color5_attach);
 
-        // link our shader's locs to the correct OpenGL texture unit
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color0Tex"), 0);
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color1Tex"), 1);
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color2Tex"), 2);
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color3Tex"), 3);
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color4Tex"), 4);
-        glUniform1i(rlGetLocationUniform(shader_display.id, "color5Tex"), 5);
-
         rlLoadDrawQuad();
         EndShaderMode();
 
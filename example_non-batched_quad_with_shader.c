@@ -58,6 +58,16 @@ int main(void)
     // used to visualize one selected draw buffer from shader
     int selectTexLoc = GetShaderLocation(shader_display, "tex_select");
 
+    // link our shader's samplers to the correct OpenGL texture unit
+    // NOTE: sampler uniforms keep their value in the program, so this is done once and not every frame
+    rlEnableShader(shader_display.id);
+    for (int i = 0; i < 6; i++)
+    {
+        int samplerLoc = rlGetLocationUniform(shader_display.id, TextFormat("mytexture%i", i));
+        rlSetUniform(samplerLoc, &i, RL_SHADER_UNIFORM_INT, 1);
+    }
+    rlDisableShader();
+
     Image tmp_image;
     tmp_image=GenImageColor(screenWidth,screenHeight,RED);
     Texture2D tex_mytexture0=LoadTextureFromImage(tmp_image);
@@ -114,20 +124,6 @@ int main(void)
         rlActiveTextureSlot(4);        rlEnableTexture(tex_mytexture4.id);
         rlActiveTextureSlot(5);        rlEnableTexture(tex_mytexture5.id);
 
-        // link our shader's locs to the correct OpenGL texture unit
-        int temp_tex_unit=0;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture0"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-        temp_tex_unit++;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture1"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-        temp_tex_unit++;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture2"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-        temp_tex_unit++;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture3"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-        temp_tex_unit++;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture4"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-        temp_tex_unit++;
-        rlSetUniform(rlGetLocationUniform(shader_display.id, "mytexture5"), &temp_tex_unit,RL_SHADER_UNIFORM_INT,1);
-
         rlLoadDrawQuad();
         
         EndShaderMode();
@@ -0,0 +1,168 @@
+/*******************************************************************************************
+*
+*   raylib example - offline render of generated sounds to WAV (no audio device, no window)
+*
+*   Renders a bank of generated sounds with GenerateSoundWave(), the same code used by
+*   example_generate_sound_at_runtime.c, and writes each one with ExportWave(). Meant for
+*   machines without sound hardware: build servers regression-testing generated audio or
+*   prebaking banks that the game then loads with LoadSound() instead of synthesising.
+*
+*   Work is split across all cores by sound: worker threads take the next sound index
+*   from an atomic counter, render it and export it.
+*   The real-time factor (seconds of audio rendered per second of wall time) is reported.
+*
+*   Usage: example_offline_sound_bake [output_dir] [wav|raw] [threads]
+*     wav: 32 bit float WAV files, raw: the float samples as they are in memory
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>         // Required for: sysconf()
+
+#include "raylib.h"
+
+#include "function_GenerateSoundWave.c"
+
+#define BANK_SIZE       64
+#define MAX_THREADS     64
+
+typedef struct BakedSoundDesc {
+    int frameCount;
+    int sampleRate;
+    float frequency;
+    float volume;
+} BakedSoundDesc;
+
+typedef struct BakeJob {
+    const BakedSoundDesc *bank;
+    int count;
+    const char *outputDir;
+    const char *extension;          // "wav" or "raw"
+    atomic_int next;                // next sound to render
+    atomic_int failed;
+} BakeJob;
+
+typedef struct BakeWorker {
+    BakeJob *job;
+    int soundsRendered;
+    double audioSeconds;
+    double busySeconds;
+    pthread_t thread;
+} BakeWorker;
+
+// Monotonic wall clock, GetTime() needs a window
+static double NowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void *BakeWorkerThread(void *arg)
+{
+    BakeWorker *worker = (BakeWorker *)arg;
+    BakeJob *job = worker->job;
+    char fileName[512];
+
+    for (int i = atomic_fetch_add(&job->next, 1); i < job->count; i = atomic_fetch_add(&job->next, 1))
+    {
+        const BakedSoundDesc *desc = &job->bank[i];
+        double start = NowSeconds();
+
+        Wave wave = GenerateSoundWave(desc->frameCount, desc->sampleRate, desc->frequency, desc->volume);
+        snprintf(fileName, sizeof(fileName), "%s/sound_%02i.%s", job->outputDir, i, job->extension);
+
+        if ((wave.data == NULL) || !ExportWave(wave, fileName))
+        {
+            printf("BAKE: [%s] Failed to render or export\n", fileName);
+            atomic_fetch_add(&job->failed, 1);
+        }
+        UnloadWave(wave);
+
+        worker->busySeconds += NowSeconds() - start;
+        worker->audioSeconds += (double)desc->frameCount/desc->sampleRate;
+        worker->soundsRendered++;
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const char *outputDir = (argc > 1)? argv[1] : "baked_sounds";
+    const char *extension = (argc > 2)? argv[2] : "wav";
+    int threadCount = (argc > 3)? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if ((strcmp(extension, "wav") != 0) && (strcmp(extension, "raw") != 0))
+    {
+        printf("BAKE: Unknown format '%s', use wav or raw\n", extension);
+        return 1;
+    }
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > MAX_THREADS) threadCount = MAX_THREADS;
+
+    // sound 0 is the sound of example_generate_sound_at_runtime.c, the rest a chromatic bank
+    static BakedSoundDesc bank[BANK_SIZE];
+    bank[0] = (BakedSoundDesc){ 10000, 48000, 48000.0f/(20.0f*PI), 1.0f };
+    for (int i = 1; i < BANK_SIZE; i++)
+    {
+        bank[i].sampleRate = 48000;
+        bank[i].frameCount = bank[i].sampleRate*(1 + i%4);                  // 1 to 4 seconds
+        bank[i].frequency = 220.0f*powf(2.0f, (i - 1)/12.0f);
+        bank[i].volume = 0.8f;
+    }
+
+    MakeDirectory(outputDir);
+
+    static BakeJob job = { 0 };
+    job.bank = bank;
+    job.count = BANK_SIZE;
+    job.outputDir = outputDir;
+    job.extension = extension;
+
+    static BakeWorker workers[MAX_THREADS] = { 0 };
+    //--------------------------------------------------------------------------------------
+
+    // Render
+    //--------------------------------------------------------------------------------------
+    double start = NowSeconds();
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        workers[t].job = &job;
+        pthread_create(&workers[t].thread, NULL, BakeWorkerThread, &workers[t]);
+    }
+
+    double audioSeconds = 0.0;
+    for (int t = 0; t < threadCount; t++)
+    {
+        pthread_join(workers[t].thread, NULL);
+        audioSeconds += workers[t].audioSeconds;
+    }
+
+    double wallSeconds = NowSeconds() - start;
+    //--------------------------------------------------------------------------------------
+
+    // Report
+    //--------------------------------------------------------------------------------------
+    for (int t = 0; t < threadCount; t++)
+    {
+        printf("BAKE: thread %2i: %3i sounds, %7.2f s audio in %6.3f s (%.0fx real-time)\n", t, workers[t].soundsRendered,
+            workers[t].audioSeconds, workers[t].busySeconds, (workers[t].busySeconds > 0.0)? workers[t].audioSeconds/workers[t].busySeconds : 0.0);
+    }
+
+    printf("BAKE: %i sounds (%.1f s of audio) written to %s/*.%s with %i threads in %.3f s: %.0fx real-time, %i failed\n",
+        BANK_SIZE, audioSeconds, outputDir, extension, threadCount, wallSeconds, (wallSeconds > 0.0)? audioSeconds/wallSeconds : 0.0, atomic_load(&job.failed));
+
+    return (atomic_load(&job.failed) == 0)? 0 : 1;
+}
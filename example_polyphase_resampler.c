@@ -0,0 +1,467 @@
+/*******************************************************************************************
+*
+*   raylib example - band-limited polyphase resampler with SIMD inner loops
+*
+*   Converts sample rates (content rate to device rate, or pitch shifting) with a
+*   windowed-sinc filter instead of leaving it to the backend's conversion:
+*     - RESAMPLER_TAPS taps per output sample, coefficients precomputed for
+*       RESAMPLER_PHASES + 1 fractional positions, the two closest are interpolated
+*     - cutoff lowered to the output Nyquist rate when downsampling (no aliasing)
+*     - dot products with AVX2/SSE2, scalar fallback
+*     - streaming state (input history and fractional position) carried between blocks,
+*       so a stream cut in arbitrary blocks gives the same output as one big block
+*   ResampleWave() plugs it into the Wave path: the sound below is generated at 44.1 kHz
+*   with GenerateSoundWave() and resampled to 48 kHz before LoadSoundFromWave().
+*
+*   The benchmark measures quality (SNR of resampled sines against the ideal signal,
+*   compared with linear interpolation) and throughput at 44.1->48 kHz, 2x and 0.5x.
+*
+*   Keys: 1 play polyphase resampled, 2 play WaveFormat() resampled, 3 play 44.1 kHz as is
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "raylib.h"
+
+#include "function_GenerateSoundWave.c"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#define RESAMPLER_TAPS      32          // multiple of 8
+#define RESAMPLER_PHASES    256
+#define RESAMPLER_BLOCK     1024        // input frames buffered per step
+#define KAISER_BETA         8.0
+#define RESAMPLER_ONE       4294967296.0    // 32.32 fixed point position
+
+typedef struct Resampler {
+    float coeffs[(RESAMPLER_PHASES + 1)*RESAMPLER_TAPS];
+    float buffer[RESAMPLER_TAPS + RESAMPLER_BLOCK];     // history + new input
+    int count;                          // valid samples in buffer
+    uint64_t position;                  // first tap of the next output, in buffer samples (32.32 fixed point)
+    uint64_t step;                      // input samples per output sample (32.32 fixed point)
+} Resampler;
+
+//----------------------------------------------------------------------------------
+// Filter design
+//----------------------------------------------------------------------------------
+// Modified Bessel function of the first kind, order 0 (series)
+static double BesselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x/(2.0*k))*(x/(2.0*k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Prepare a resampler for inRate -> outRate, cutoff follows the lower of the two rates
+void InitResampler(Resampler *r, int inRate, int outRate)
+{
+    memset(r, 0, sizeof(Resampler));
+    double ratio = (double)inRate/outRate;
+    r->step = (uint64_t)(ratio*RESAMPLER_ONE + 0.5);
+
+    double cutoff = 0.5*((ratio > 1.0)? 1.0/ratio : 1.0)*0.92;     // cycles per input sample, 8% transition band
+    const int center = RESAMPLER_TAPS/2 - 1;
+
+    for (int p = 0; p <= RESAMPLER_PHASES; p++)
+    {
+        double frac = (double)p/RESAMPLER_PHASES;
+        float *row = &r->coeffs[p*RESAMPLER_TAPS];
+        double sum = 0.0;
+
+        for (int k = 0; k < RESAMPLER_TAPS; k++)
+        {
+            double t = k - center - frac;       // distance of this tap to the output position
+            double sinc = (fabs(t) < 1e-9)? 2.0*cutoff : sin(2.0*PI*cutoff*t)/(PI*t);
+            double w = t/(RESAMPLER_TAPS/2.0);
+            double window = (fabs(w) <= 1.0)? BesselI0(KAISER_BETA*sqrt(1.0 - w*w))/BesselI0(KAISER_BETA) : 0.0;
+            row[k] = (float)(sinc*window);
+            sum += row[k];
+        }
+
+        for (int k = 0; k < RESAMPLER_TAPS; k++) row[k] = (float)(row[k]/sum);     // unity gain at DC
+    }
+
+    // history starts as silence, with the first input sample at the filter center
+    r->count = center;
+}
+
+// Change the ratio while streaming (pitch shift), the filter is kept
+// NOTE: design the filter for the highest step that will be used to avoid aliasing
+void SetResamplerStep(Resampler *r, double step)
+{
+    r->step = (uint64_t)(step*RESAMPLER_ONE + 0.5);
+}
+
+//----------------------------------------------------------------------------------
+// SIMD dot products against two coefficient rows at once
+//----------------------------------------------------------------------------------
+static inline void DotPair(const float *c0, const float *c1, const float *x, float *d0, float *d1)
+{
+#if defined(__AVX2__)
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    for (int k = 0; k < RESAMPLER_TAPS; k += 8)
+    {
+        __m256 v = _mm256_loadu_ps(x + k);
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(c0 + k), v));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(c1 + k), v));
+    }
+    __m128 s0 = _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+    __m128 s1 = _mm_add_ps(_mm256_castps256_ps128(a1), _mm256_extractf128_ps(a1, 1));
+#elif defined(__SSE2__)
+    __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+    for (int k = 0; k < RESAMPLER_TAPS; k += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + k);
+        s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(c0 + k), v));
+        s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(c1 + k), v));
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    // horizontal sums of both accumulators
+    __m128 lo = _mm_unpacklo_ps(s0, s1);        // a0 b0 a1 b1
+    __m128 hi = _mm_unpackhi_ps(s0, s1);        // a2 b2 a3 b3
+    __m128 sum = _mm_add_ps(lo, hi);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    *d0 = _mm_cvtss_f32(sum);
+    *d1 = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+    float a0 = 0.0f, a1 = 0.0f;
+    for (int k = 0; k < RESAMPLER_TAPS; k++) { a0 += c0[k]*x[k]; a1 += c1[k]*x[k]; }
+    *d0 = a0;
+    *d1 = a1;
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Streaming
+//----------------------------------------------------------------------------------
+// Maximum number of frames ResampleProcess() can write for inCount input frames
+int GetResamplerMaxOutput(const Resampler *r, int inCount)
+{
+    return (int)ceil((inCount + RESAMPLER_TAPS)*RESAMPLER_ONE/r->step) + 2;
+}
+
+// Resample a block of input, returns the number of output frames written
+// NOTE: outCapacity should be at least GetResamplerMaxOutput(), input that does not fit is dropped
+int ResampleProcess(Resampler *r, const float *in, int inCount, float *out, int outCapacity)
+{
+    int produced = 0;
+
+    while (inCount > 0)
+    {
+        int space = RESAMPLER_TAPS + RESAMPLER_BLOCK - r->count;
+        int n = (inCount < space)? inCount : space;
+        memcpy(r->buffer + r->count, in, n*sizeof(float));
+        r->count += n;
+        in += n;
+        inCount -= n;
+
+        // every output whose taps are all in the buffer
+        while (((int)(r->position >> 32) + RESAMPLER_TAPS <= r->count) && (produced < outCapacity))
+        {
+            int index = (int)(r->position >> 32);
+            uint32_t f = (uint32_t)r->position;
+            int p = f >> 24;                        // top 8 fraction bits select the phase (0..RESAMPLER_PHASES - 1)
+            float d0, d1;
+
+            DotPair(&r->coeffs[p*RESAMPLER_TAPS], &r->coeffs[(p + 1)*RESAMPLER_TAPS], r->buffer + index, &d0, &d1);
+            out[produced++] = d0 + (d1 - d0)*((f & 0xffffff)*(1.0f/16777216.0f));
+            r->position += r->step;
+        }
+
+        if (produced >= outCapacity)
+        {
+            TRACELOG(LOG_WARNING, "RESAMPLER: Output buffer full, %i input frames dropped", inCount);
+            break;
+        }
+
+        // drop the samples no future output needs
+        int drop = (int)(r->position >> 32);
+        if (drop > r->count) drop = r->count;
+        memmove(r->buffer, r->buffer + drop, (r->count - drop)*sizeof(float));
+        r->count -= drop;
+        r->position -= (uint64_t)drop << 32;
+    }
+
+    return produced;
+}
+
+// Push silence through the filter to get the outputs of the last input samples
+int ResampleFlush(Resampler *r, float *out, int outCapacity)
+{
+    static const float silence[RESAMPLER_TAPS] = { 0 };
+    return ResampleProcess(r, silence, RESAMPLER_TAPS/2 + 1, out, outCapacity);
+}
+
+// Resample a Wave to a new sample rate, output is 32 bit float with the same channels
+// NOTE: returns an empty Wave on failure, the input wave is not modified
+Wave ResampleWave(Wave wave, int sampleRate)
+{
+    Wave result = { 0 };
+    if ((wave.data == NULL) || (wave.frameCount == 0)) return result;
+
+    float *samples = LoadWaveSamples(wave);         // interleaved float
+    int outFrames = (int)((double)wave.frameCount*sampleRate/wave.sampleRate);
+    Resampler *r = (Resampler *)RL_MALLOC(sizeof(Resampler));
+    float *in = (float *)RL_MALLOC(wave.frameCount*sizeof(float));
+
+    // same ratio for every channel, the flush pushes RESAMPLER_TAPS/2 + 1 more frames
+    InitResampler(r, wave.sampleRate, sampleRate);
+    int capacity = GetResamplerMaxOutput(r, wave.frameCount + RESAMPLER_TAPS/2 + 1);
+    float *channel = (float *)RL_MALLOC(capacity*sizeof(float));
+    float *out = (float *)RL_CALLOC((size_t)outFrames*wave.channels, sizeof(float));
+
+    for (unsigned int c = 0; c < wave.channels; c++)
+    {
+        for (unsigned int i = 0; i < wave.frameCount; i++) in[i] = samples[i*wave.channels + c];
+
+        InitResampler(r, wave.sampleRate, sampleRate);
+        int produced = ResampleProcess(r, in, wave.frameCount, channel, capacity);
+        produced += ResampleFlush(r, channel + produced, capacity - produced);
+
+        for (int i = 0; (i < outFrames) && (i < produced); i++) out[i*wave.channels + c] = channel[i];
+    }
+
+    RL_FREE(channel);
+    RL_FREE(in);
+    RL_FREE(r);
+    UnloadWaveSamples(samples);
+
+    result.frameCount = outFrames;
+    result.sampleRate = sampleRate;
+    result.sampleSize = 32;
+    result.channels = wave.channels;
+    result.data = out;
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------------
+#define BENCH_RATIOS        3
+#define BENCH_SECONDS       4
+
+typedef struct ResamplerBench {
+    const char *name;
+    int inRate;
+    int outRate;
+    double snrPolyphase;                // dB, sine at 1 kHz and at 40% of the lower Nyquist rate (worst)
+    double snrLinear;
+    double aliasPolyphase;              // dB, rejection of a tone above the output Nyquist rate (downsampling only)
+    double aliasLinear;
+    double msamplesPolyphase;           // output Msamples/s
+    double msamplesLinear;
+    double streamError;                 // max difference between block streaming and one shot
+} ResamplerBench;
+
+// Linear interpolation reference
+static int ResampleLinear(const float *in, int inCount, double step, float *out)
+{
+    int produced = 0;
+    for (double pos = 0.0; pos < inCount - 1; pos += step)
+    {
+        int i = (int)pos;
+        float f = (float)(pos - i);
+        out[produced++] = in[i] + (in[i + 1] - in[i])*f;
+    }
+    return produced;
+}
+
+// Power of out relative to a 0.5 amplitude sine, edges skipped
+static double RelativePower(const float *out, int count)
+{
+    double power = 0.0;
+    int n = 0;
+    for (int i = RESAMPLER_TAPS*4; i < count - RESAMPLER_TAPS*4; i++, n++) power += out[i]*out[i];
+    return 10.0*log10(fmax(power/n, 1e-30)/0.125);
+}
+
+// SNR of out against the ideal sine, edges skipped
+static double SineSNR(const float *out, int count, double frequency, int outRate)
+{
+    double signal = 0.0, noise = 0.0;
+    for (int i = RESAMPLER_TAPS*4; i < count - RESAMPLER_TAPS*4; i++)
+    {
+        double ideal = 0.5*sin(2.0*PI*frequency*i/outRate);
+        signal += ideal*ideal;
+        noise += (out[i] - ideal)*(out[i] - ideal);
+    }
+    return 10.0*log10(signal/fmax(noise, 1e-30));
+}
+
+void RunResamplerBenchmark(ResamplerBench *bench, int count)
+{
+    Resampler *r = (Resampler *)RL_MALLOC(sizeof(Resampler));
+
+    for (int b = 0; b < count; b++)
+    {
+        int inCount = bench[b].inRate*BENCH_SECONDS;
+        double step = (double)bench[b].inRate/bench[b].outRate;
+        int outMax = (int)(inCount/step) + RESAMPLER_TAPS*4;
+        float *in = (float *)RL_MALLOC(inCount*sizeof(float));
+        float *out = (float *)RL_MALLOC(outMax*sizeof(float));
+        float *streamed = (float *)RL_MALLOC(outMax*sizeof(float));
+
+        // quality: worst SNR over a low and a high frequency sine
+        double nyquist = 0.5*((bench[b].inRate < bench[b].outRate)? bench[b].inRate : bench[b].outRate);
+        const double frequencies[2] = { 1000.0, 0.4*nyquist };
+        bench[b].snrPolyphase = 1000.0;
+        bench[b].snrLinear = 1000.0;
+
+        for (int f = 0; f < 2; f++)
+        {
+            for (int i = 0; i < inCount; i++) in[i] = (float)(0.5*sin(2.0*PI*frequencies[f]*i/bench[b].inRate));
+
+            InitResampler(r, bench[b].inRate, bench[b].outRate);
+            int produced = ResampleProcess(r, in, inCount, out, outMax);
+            bench[b].snrPolyphase = fmin(bench[b].snrPolyphase, SineSNR(out, produced, frequencies[f], bench[b].outRate));
+
+            produced = ResampleLinear(in, inCount, step, out);
+            bench[b].snrLinear = fmin(bench[b].snrLinear, SineSNR(out, produced, frequencies[f], bench[b].outRate));
+        }
+
+        // aliasing: a tone between the output and the input Nyquist rates must disappear
+        bench[b].aliasPolyphase = 0.0;
+        bench[b].aliasLinear = 0.0;
+        if (bench[b].inRate > bench[b].outRate)
+        {
+            double frequency = 0.25*(bench[b].inRate + bench[b].outRate);
+            for (int i = 0; i < inCount; i++) in[i] = (float)(0.5*sin(2.0*PI*frequency*i/bench[b].inRate));
+
+            InitResampler(r, bench[b].inRate, bench[b].outRate);
+            int produced = ResampleProcess(r, in, inCount, out, outMax);
+            bench[b].aliasPolyphase = -RelativePower(out, produced);
+
+            produced = ResampleLinear(in, inCount, step, out);
+            bench[b].aliasLinear = -RelativePower(out, produced);
+        }
+
+        // throughput: one shot over the whole buffer
+        InitResampler(r, bench[b].inRate, bench[b].outRate);
+        double start = GetTime();
+        int produced = ResampleProcess(r, in, inCount, out, outMax);
+        bench[b].msamplesPolyphase = produced/((GetTime() - start)*1e6);
+
+        start = GetTime();
+        int producedLinear = ResampleLinear(in, inCount, step, streamed);
+        bench[b].msamplesLinear = producedLinear/((GetTime() - start)*1e6);
+
+        // streaming: same input in odd sized blocks must give the same output
+        InitResampler(r, bench[b].inRate, bench[b].outRate);
+        int streamedCount = 0;
+        for (int done = 0, block = 1; done < inCount; done += block, block = (block*7 + 13)%997 + 1)
+        {
+            int n = ((inCount - done) < block)? (inCount - done) : block;
+            streamedCount += ResampleProcess(r, in + done, n, streamed + streamedCount, outMax - streamedCount);
+        }
+        bench[b].streamError = (streamedCount == produced)? 0.0 : 1.0;
+        for (int i = 0; (i < produced) && (i < streamedCount); i++) bench[b].streamError = fmax(bench[b].streamError, fabs(out[i] - streamed[i]));
+
+        printf("RESAMPLER: %-15s polyphase SNR %5.1f dB alias -%5.1f dB %6.1f Msamples/s | linear SNR %5.1f dB alias -%5.1f dB %6.1f Msamples/s | stream error %g\n",
+            bench[b].name, bench[b].snrPolyphase, bench[b].aliasPolyphase, bench[b].msamplesPolyphase,
+            bench[b].snrLinear, bench[b].aliasLinear, bench[b].msamplesLinear, bench[b].streamError);
+
+        RL_FREE(streamed);
+        RL_FREE(out);
+        RL_FREE(in);
+    }
+
+    RL_FREE(r);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - polyphase resampler");
+
+    ResamplerBench bench[BENCH_RATIOS] = {
+        { .name = "44.1 -> 48 kHz", .inRate = 44100, .outRate = 48000 },
+        { .name = "2x (24 -> 48)", .inRate = 24000, .outRate = 48000 },
+        { .name = "0.5x (96 -> 48)", .inRate = 96000, .outRate = 48000 },
+    };
+    RunResamplerBenchmark(bench, BENCH_RATIOS);
+
+    InitAudioDevice();
+
+    // content generated at 44.1 kHz, converted to the 48 kHz the device runs at
+    Wave original = GenerateSoundWave(44100, 44100, 880.0f, 0.8f);
+    Wave polyphase = ResampleWave(original, 48000);
+    Wave backend = WaveCopy(original);
+    WaveFormat(&backend, 48000, 32, 1);
+
+    Sound sounds[3] = { LoadSoundFromWave(polyphase), LoadSoundFromWave(backend), LoadSoundFromWave(original) };
+    const char *names[3] = { "polyphase resampled", "WaveFormat() resampled", "44.1 kHz as is" };
+    int playing = -1;
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        for (int i = 0; i < 3; i++)
+        {
+            if (IsKeyPressed(KEY_ONE + i))
+            {
+                PlaySound(sounds[i]);
+                playing = i;
+            }
+        }
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(BLACK);
+
+            DrawText(TextFormat("Polyphase: %i taps, %i phases", RESAMPLER_TAPS, RESAMPLER_PHASES), 20, 20, 20, LIGHTGRAY);
+            DrawText("ratio", 20, 60, 20, GRAY);
+            DrawText("polyphase SNR/alias/Ms/s", 200, 60, 20, GRAY);
+            DrawText("linear SNR/alias/Ms/s", 480, 60, 20, GRAY);
+            for (int b = 0; b < BENCH_RATIOS; b++)
+            {
+                DrawText(bench[b].name, 20, 90 + b*25, 20, LIGHTGRAY);
+                DrawText(TextFormat("%.1f / -%.1f dB / %.1f", bench[b].snrPolyphase, bench[b].aliasPolyphase, bench[b].msamplesPolyphase), 200, 90 + b*25, 20, GREEN);
+                DrawText(TextFormat("%.1f / -%.1f dB / %.1f", bench[b].snrLinear, bench[b].aliasLinear, bench[b].msamplesLinear), 480, 90 + b*25, 20, LIGHTGRAY);
+                if (bench[b].streamError > 0.0) DrawText("stream mismatch", 650, 90 + b*25, 20, RED);
+            }
+            DrawText("1: polyphase   2: WaveFormat()   3: original", 20, 200, 20, LIGHTGRAY);
+            if (playing >= 0) DrawText(TextFormat("Playing: %s", names[playing]), 20, 230, 20, ORANGE);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int i = 0; i < 3; i++) UnloadSound(sounds[i]);
+    UnloadWave(original);
+    UnloadWave(polyphase);
+    UnloadWave(backend);
+    CloseAudioDevice();   // Close audio device
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -0,0 +1,387 @@
+/*******************************************************************************************
+*
+*   raylib example - time-sliced environment cubemap reflection probes
+*
+*   Every probe owns a cubemap rendered from its position. Rendering all 6 faces every
+*   frame costs 6 scene passes per probe, so probe faces are updated time-sliced:
+*     - faces whose contents changed (a moving object's bounds touch the face's view
+*       pyramid) are re-rendered first
+*     - otherwise faces are refreshed round-robin
+*   with at most faceBudget faces rendered per frame across all probes.
+*
+*   Probes are bound to materials with SetMaterialShaderTexture() on unit 7, the unit
+*   DrawMesh() binds as a cubemap (MATERIAL_MAP_CUBEMAP).
+*
+*   Keys: A render all faces every frame (no time slicing), R toggle round-robin refresh
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+#include "function_SetMaterialShaderTexture.c"
+
+#define MAX_PROBES          8
+#define PROBE_SIZE          256
+
+typedef struct ReflectionProbe {
+    Vector3 position;
+    Texture2D cubemap;                  // id is a GL_TEXTURE_CUBE_MAP
+    bool faceDirty[6];
+    int nextFace;                       // next face to update (dirty or round-robin)
+} ReflectionProbe;
+
+typedef struct ProbeCache {
+    ReflectionProbe probes[MAX_PROBES];
+    int count;
+    unsigned int fbo;
+    unsigned int depth;                 // shared by all probes, faces are rendered one at a time
+    int size;
+    int faceBudget;                     // faces rendered per frame, all probes together
+    bool roundRobin;                    // refresh clean faces when there are no dirty ones
+    int nextProbe;                      // round-robin position
+    int nextDirtyProbe;                 // first probe checked for dirty faces
+
+    int facesRendered;                  // last update
+} ProbeCache;
+
+typedef void (*DrawProbeSceneFunc)(void);
+
+// Face directions and up vectors in GL cubemap face order (+X, -X, +Y, -Y, +Z, -Z)
+static const Vector3 faceDirection[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+static const Vector3 faceUp[6] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+
+void InitProbeCache(ProbeCache *cache, int size, int faceBudget)
+{
+    *cache = (ProbeCache){ 0 };
+    cache->size = size;
+    cache->faceBudget = faceBudget;
+    cache->roundRobin = true;
+
+    cache->fbo = rlLoadFramebuffer();
+    glGenRenderbuffers(1, &cache->depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, cache->depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    rlFramebufferAttach(cache->fbo, cache->depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+}
+
+// Add a probe, all of its faces start dirty; returns the probe index or -1
+int AddReflectionProbe(ProbeCache *cache, Vector3 position)
+{
+    if (cache->count >= MAX_PROBES) return -1;
+
+    ReflectionProbe *probe = &cache->probes[cache->count];
+    *probe = (ReflectionProbe){ 0 };
+    probe->position = position;
+
+    glGenTextures(1, &probe->cubemap.id);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, probe->cubemap.id);
+    for (int f = 0; f < 6; f++) glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_RGBA8, cache->size, cache->size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    probe->cubemap.width = cache->size;
+    probe->cubemap.height = cache->size;
+    probe->cubemap.mipmaps = 1;
+    probe->cubemap.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+    for (int f = 0; f < 6; f++) probe->faceDirty[f] = true;
+
+    return cache->count++;
+}
+
+// Mark the faces of every probe that can see (part of) the box
+// NOTE: call with the old and the new bounds of a moving object
+void MarkReflectionProbesDirty(ProbeCache *cache, BoundingBox box)
+{
+    for (int p = 0; p < cache->count; p++)
+    {
+        ReflectionProbe *probe = &cache->probes[p];
+        Vector3 min = Vector3Subtract(box.min, probe->position);
+        Vector3 max = Vector3Subtract(box.max, probe->position);
+        float lo[3] = { min.x, min.y, min.z };
+        float hi[3] = { max.x, max.y, max.z };
+
+        // face +axis sees the box if some box point has axis >= |other axes|:
+        // take the farthest value along the axis and the values closest to 0 on the others
+        for (int f = 0; f < 6; f++)
+        {
+            int axis = f/2;
+            float along = (f%2 == 0)? hi[axis] : -lo[axis];
+            if (along <= 0.0f) continue;
+
+            bool visible = true;
+            for (int other = 0; other < 3; other++)
+            {
+                if (other == axis) continue;
+                float closest = (lo[other] > 0.0f)? lo[other] : ((hi[other] < 0.0f)? -hi[other] : 0.0f);
+                if (closest > along) visible = false;
+            }
+
+            if (visible) probe->faceDirty[f] = true;
+        }
+    }
+}
+
+static void RenderProbeFace(ProbeCache *cache, ReflectionProbe *probe, int face, DrawProbeSceneFunc drawScene)
+{
+    rlFramebufferAttach(cache->fbo, probe->cubemap.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_CUBEMAP_POSITIVE_X + face, 0);
+
+    // BeginTextureMode() only needs the fbo id and its size
+    RenderTexture2D target = { 0 };
+    target.id = cache->fbo;
+    target.texture.width = cache->size;
+    target.texture.height = cache->size;
+
+    Camera3D camera = { 0 };
+    camera.position = probe->position;
+    camera.target = Vector3Add(probe->position, faceDirection[face]);
+    camera.up = faceUp[face];
+    camera.fovy = 90.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    BeginTextureMode(target);
+        ClearBackground(SKYBLUE);
+        BeginMode3D(camera);
+            drawScene();
+        EndMode3D();
+    EndTextureMode();
+
+    probe->faceDirty[face] = false;
+    cache->facesRendered++;
+}
+
+// Render up to faceBudget probe faces: dirty faces first, then round-robin if enabled
+// NOTE: call outside BeginDrawing()/EndDrawing() or outside any other texture mode
+void UpdateReflectionProbes(ProbeCache *cache, DrawProbeSceneFunc drawScene)
+{
+    cache->facesRendered = 0;
+    if (cache->count == 0) return;
+
+    // dirty faces, one per probe per round, starting at a rotating probe and face
+    // so that no probe or face is starved while objects keep moving
+    bool found = true;
+    while (found && (cache->facesRendered < cache->faceBudget))
+    {
+        found = false;
+        for (int n = 0; (n < cache->count) && (cache->facesRendered < cache->faceBudget); n++)
+        {
+            ReflectionProbe *probe = &cache->probes[(cache->nextDirtyProbe + n)%cache->count];
+            for (int k = 0; k < 6; k++)
+            {
+                int face = (probe->nextFace + k)%6;
+                if (probe->faceDirty[face])
+                {
+                    RenderProbeFace(cache, probe, face, drawScene);
+                    probe->nextFace = (face + 1)%6;
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    cache->nextDirtyProbe = (cache->nextDirtyProbe + 1)%cache->count;
+
+    // leftover budget refreshes faces round-robin (picks up changes nobody reported)
+    while (cache->roundRobin && (cache->facesRendered < cache->faceBudget))
+    {
+        ReflectionProbe *probe = &cache->probes[cache->nextProbe];
+        RenderProbeFace(cache, probe, probe->nextFace, drawScene);
+
+        probe->nextFace = (probe->nextFace + 1)%6;
+        if (probe->nextFace == 0) cache->nextProbe = (cache->nextProbe + 1)%cache->count;
+
+        if (cache->facesRendered >= cache->count*6) break;      // budget larger than all faces
+    }
+}
+
+// Index of the probe closest to a position, -1 if there are none
+int GetClosestReflectionProbe(ProbeCache *cache, Vector3 position)
+{
+    int closest = -1;
+    float best = 0.0f;
+
+    for (int p = 0; p < cache->count; p++)
+    {
+        float d = Vector3DistanceSqr(cache->probes[p].position, position);
+        if ((closest == -1) || (d < best)) { closest = p; best = d; }
+    }
+
+    return closest;
+}
+
+void UnloadProbeCache(ProbeCache *cache)
+{
+    for (int p = 0; p < cache->count; p++) glDeleteTextures(1, &cache->probes[p].cubemap.id);
+    glDeleteRenderbuffers(1, &cache->depth);
+    glDeleteFramebuffers(1, &cache->fbo);     // not rlUnloadFramebuffer(), it would delete the depth attachment again
+    cache->count = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Reflective material shader
+//----------------------------------------------------------------------------------
+const char* reflectShader_vs=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"in vec3 vertexNormal;\n"
+"uniform mat4 mvp;\n"
+"uniform mat4 matModel;\n"
+"out vec3 fragPosition;\n"
+"out vec3 fragNormal;\n"
+"void main()\n"
+"{\n"
+"    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0));\n"
+"    fragNormal = mat3(matModel)*vertexNormal;\n"
+"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+"}\n";
+
+const char* reflectShader_fs=
+"#version 330\n"
+"in vec3 fragPosition;\n"
+"in vec3 fragNormal;\n"
+"uniform samplerCube environmentMap;\n"
+"uniform vec3 viewPos;\n"
+"uniform vec4 colDiffuse;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    vec3 r = reflect(normalize(fragPosition - viewPos), normalize(fragNormal));\n"
+"    finalColor = vec4(texture(environmentMap, r).rgb*colDiffuse.rgb, 1.0);\n"
+"}\n";
+
+//----------------------------------------------------------------------------------
+// Scene
+//----------------------------------------------------------------------------------
+#define NUM_CUBES   6
+
+Vector3 cubePositions[NUM_CUBES];
+Color cubeColors[NUM_CUBES] = { RED, GREEN, BLUE, ORANGE, PURPLE, YELLOW };
+
+// What the probes see: everything except the reflective spheres
+void DrawEnvironment(void)
+{
+    DrawPlane((Vector3){ 0, 0, 0 }, (Vector2){ 40, 40 }, DARKGREEN);
+    for (int i = 0; i < NUM_CUBES; i++) DrawCube(cubePositions[i], 1.5f, 1.5f, 1.5f, cubeColors[i]);
+}
+
+static BoundingBox CubeBounds(Vector3 position)
+{
+    return (BoundingBox){ Vector3SubtractValue(position, 0.75f), Vector3AddValue(position, 0.75f) };
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - time-sliced reflection probes");
+
+    Camera3D camera = { 0 };
+    camera.position = (Vector3){ 0, 6, 14 };
+    camera.target = (Vector3){ 0, 1.5f, 0 };
+    camera.up = (Vector3){ 0, 1, 0 };
+    camera.fovy = 45;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    ProbeCache probes;
+    InitProbeCache(&probes, PROBE_SIZE, 1);
+
+    Vector3 spherePositions[2] = { { -3, 2, 0 }, { 3, 2, 0 } };
+    Shader reflectShader = LoadShaderFromMemory(reflectShader_vs, reflectShader_fs);
+    int viewPosLoc = GetShaderLocation(reflectShader, "viewPos");
+    Model spheres[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        spheres[i] = LoadModelFromMesh(GenMeshSphere(1.5f, 32, 32));
+        spheres[i].materials[0].shader = reflectShader;
+
+        int probe = AddReflectionProbe(&probes, spherePositions[i]);
+        int result = SetMaterialShaderTexture(&spheres[i].materials[0], MATERIAL_MAP_CUBEMAP, probes.probes[probe].cubemap, "environmentMap");
+        if (result != 0) printf("PROBES: SetMaterialShaderTexture() failed (%i)\n", result);
+    }
+
+    bool allFaces = false;
+    double probeMs = 0;
+
+    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyPressed(KEY_A)) allFaces = !allFaces;
+        if (IsKeyPressed(KEY_R)) probes.roundRobin = !probes.roundRobin;
+        probes.faceBudget = allFaces? 6*probes.count : 1;
+
+        // orbiting cubes: the faces that saw them before or see them now need an update
+        float t = (float)GetTime();
+        for (int i = 0; i < NUM_CUBES; i++)
+        {
+            Vector3 old = cubePositions[i];
+            float angle = t*0.5f + i*2.0f*PI/NUM_CUBES;
+            cubePositions[i] = (Vector3){ cosf(angle)*8.0f, 0.75f + ((i%2)? fabsf(sinf(t*2.0f + i))*2.0f : 0.0f), sinf(angle)*8.0f };
+
+            MarkReflectionProbesDirty(&probes, CubeBounds(old));
+            MarkReflectionProbesDirty(&probes, CubeBounds(cubePositions[i]));
+        }
+
+        double start = GetTime();
+        UpdateReflectionProbes(&probes, DrawEnvironment);
+        probeMs = (GetTime() - start)*1000.0;
+
+        UpdateCamera(&camera, CAMERA_ORBITAL);
+        SetShaderValue(reflectShader, viewPosLoc, &camera.position, SHADER_UNIFORM_VEC3);
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+            ClearBackground(SKYBLUE);
+
+            BeginMode3D(camera);
+                DrawEnvironment();
+                for (int i = 0; i < 2; i++) DrawModel(spheres[i], spherePositions[i], 1.0f, WHITE);
+            EndMode3D();
+
+            DrawText(TextFormat("Probe faces rendered this frame: %i (%.2f ms CPU)", probes.facesRendered, probeMs), 10, 30, 20, BLACK);
+            DrawText(TextFormat("A: %s   R: round-robin refresh %s", allFaces? "all faces every frame" : "time-sliced, 1 face per frame", probes.roundRobin? "on" : "off"), 10, 55, 20, BLACK);
+            DrawFPS(10, 10);
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int i = 0; i < 2; i++)
+    {
+        // the shader is shared and the cubemaps belong to the probe cache
+        spheres[i].materials[0].shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+        spheres[i].materials[0].maps[MATERIAL_MAP_CUBEMAP].texture = (Texture2D){ 0 };
+        UnloadModel(spheres[i]);
+    }
+    UnloadShader(reflectShader);
+    UnloadProbeCache(&probes);
+
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -0,0 +1,459 @@
+/*******************************************************************************************
+*
+*   raylib example - small render graph (frame graph) with transient render target aliasing
+*
+*   Passes are declared with the resources they read and write. The graph:
+*     1) orders the passes automatically (a pass runs after the passes producing what it reads)
+*     2) finds the first and last pass using each transient render target
+*     3) lets transient targets whose lifetimes don't overlap share the same RenderTexture
+*
+*   The bloom chain below declares 4 intermediate targets but only needs 3 real ones:
+*   "bright" is dead once "blurH" was produced, so "blurV" reuses its memory.
+*   Passes are declared out of order on purpose.
+*
+*   NOTE: an aliased target contains whatever the previous user left in it, passes must
+*   clear (or fully overwrite) every target they write.
+*
+********************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#define MAX_RG_RESOURCES        16
+#define MAX_RG_PASSES           16
+#define MAX_RG_PASS_IO          4       // max reads and max writes per pass
+#define RG_BACKBUFFER           -1      // write target meaning "the screen"
+
+typedef struct RenderGraph RenderGraph;
+typedef struct RGPass RGPass;
+
+typedef void (*RGExecuteFunc)(RenderGraph *graph, RGPass *pass, void *userData);
+
+typedef struct RGResource {
+    const char *name;
+    int width;
+    int height;
+    int firstPass;                      // position in the sorted order of the first/last user
+    int lastPass;
+    int physical;                       // index in graph->targets, -1 until compiled
+} RGResource;
+
+struct RGPass {
+    const char *name;
+    int reads[MAX_RG_PASS_IO];
+    int readCount;
+    int writes[MAX_RG_PASS_IO];
+    int writeCount;
+    RGExecuteFunc execute;
+    void *userData;
+};
+
+struct RenderGraph {
+    RGResource resources[MAX_RG_RESOURCES];
+    int resourceCount;
+    RGPass passes[MAX_RG_PASSES];
+    int passCount;
+
+    int order[MAX_RG_PASSES];           // pass indices in execution order
+    bool compiled;
+
+    RenderTexture2D targets[MAX_RG_RESOURCES];  // real GPU targets, shared by aliased resources
+    int targetLastPass[MAX_RG_RESOURCES];       // last sorted position using each real target
+    int targetCount;
+};
+
+// Declare a transient render target, returns its handle
+int AddGraphResource(RenderGraph *graph, const char *name, int width, int height)
+{
+    if (graph->resourceCount >= MAX_RG_RESOURCES) return -1;
+
+    RGResource *res = &graph->resources[graph->resourceCount];
+    res->name = name;
+    res->width = width;
+    res->height = height;
+    res->firstPass = -1;
+    res->lastPass = -1;
+    res->physical = -1;
+
+    graph->compiled = false;
+    return graph->resourceCount++;
+}
+
+// Declare a pass, use GraphPassRead()/GraphPassWrite() on the returned pass to set its resources
+RGPass *AddGraphPass(RenderGraph *graph, const char *name, RGExecuteFunc execute, void *userData)
+{
+    if (graph->passCount >= MAX_RG_PASSES) return NULL;
+
+    RGPass *pass = &graph->passes[graph->passCount++];
+    pass->name = name;
+    pass->readCount = 0;
+    pass->writeCount = 0;
+    pass->execute = execute;
+    pass->userData = userData;
+
+    graph->compiled = false;
+    return pass;
+}
+
+void GraphPassRead(RGPass *pass, int resource)
+{
+    if (pass->readCount < MAX_RG_PASS_IO) pass->reads[pass->readCount++] = resource;
+}
+
+void GraphPassWrite(RGPass *pass, int resource)
+{
+    if (pass->writeCount < MAX_RG_PASS_IO) pass->writes[pass->writeCount++] = resource;
+}
+
+// Returns true if pass a writes something pass b reads
+static bool GraphPassDependsOn(const RGPass *b, const RGPass *a)
+{
+    for (int r = 0; r < b->readCount; r++)
+        for (int w = 0; w < a->writeCount; w++)
+            if ((b->reads[r] == a->writes[w]) && (b->reads[r] != RG_BACKBUFFER)) return true;
+
+    return false;
+}
+
+// Sort passes, compute lifetimes and assign (alias) real render targets
+// NOTE: render targets are only created here, call again after adding passes or resources
+bool CompileRenderGraph(RenderGraph *graph)
+{
+    // Topological sort (Kahn), declaration order is kept between independent passes
+    int dependencies[MAX_RG_PASSES] = { 0 };
+    bool scheduled[MAX_RG_PASSES] = { 0 };
+
+    for (int b = 0; b < graph->passCount; b++)
+        for (int a = 0; a < graph->passCount; a++)
+            if ((a != b) && GraphPassDependsOn(&graph->passes[b], &graph->passes[a])) dependencies[b]++;
+
+    for (int n = 0; n < graph->passCount; n++)
+    {
+        int next = -1;
+        for (int p = 0; p < graph->passCount; p++)
+        {
+            if (!scheduled[p] && (dependencies[p] == 0)) { next = p; break; }
+        }
+
+        if (next == -1)
+        {
+            TRACELOG(LOG_WARNING, "RENDERGRAPH: Cycle between passes, graph can not be compiled");
+            return false;
+        }
+
+        scheduled[next] = true;
+        graph->order[n] = next;
+
+        for (int p = 0; p < graph->passCount; p++)
+            if (!scheduled[p] && GraphPassDependsOn(&graph->passes[p], &graph->passes[next])) dependencies[p]--;
+    }
+
+    // Lifetimes, in sorted positions
+    for (int r = 0; r < graph->resourceCount; r++)
+    {
+        graph->resources[r].firstPass = -1;
+        graph->resources[r].lastPass = -1;
+        graph->resources[r].physical = -1;
+    }
+
+    for (int n = 0; n < graph->passCount; n++)
+    {
+        RGPass *pass = &graph->passes[graph->order[n]];
+        int used[2*MAX_RG_PASS_IO];
+        int usedCount = 0;
+        for (int i = 0; i < pass->readCount; i++) used[usedCount++] = pass->reads[i];
+        for (int i = 0; i < pass->writeCount; i++) used[usedCount++] = pass->writes[i];
+
+        for (int i = 0; i < usedCount; i++)
+        {
+            if (used[i] == RG_BACKBUFFER) continue;
+            RGResource *res = &graph->resources[used[i]];
+            if (res->firstPass == -1) res->firstPass = n;
+            res->lastPass = n;
+        }
+    }
+
+    // Release targets from a previous compile
+    for (int t = 0; t < graph->targetCount; t++) UnloadRenderTexture(graph->targets[t]);
+    graph->targetCount = 0;
+
+    // Greedy aliasing: walk resources by first use, reuse a real target of the same
+    // size whose last user ran before this resource is first written
+    for (int n = 0; n < graph->passCount; n++)
+    {
+        for (int r = 0; r < graph->resourceCount; r++)
+        {
+            RGResource *res = &graph->resources[r];
+            if (res->firstPass != n) continue;
+
+            res->physical = -1;
+            for (int t = 0; t < graph->targetCount; t++)
+            {
+                if ((graph->targetLastPass[t] < n) &&
+                    (graph->targets[t].texture.width == res->width) &&
+                    (graph->targets[t].texture.height == res->height))
+                {
+                    res->physical = t;
+                    break;
+                }
+            }
+
+            if (res->physical == -1)
+            {
+                res->physical = graph->targetCount;
+                graph->targets[graph->targetCount++] = LoadRenderTexture(res->width, res->height);
+            }
+
+            graph->targetLastPass[res->physical] = res->lastPass;
+        }
+    }
+
+    // Resources no pass reads or writes get no target
+    for (int r = 0; r < graph->resourceCount; r++)
+    {
+        if (graph->resources[r].physical == -1) TRACELOG(LOG_WARNING, "RENDERGRAPH: Resource %s is not used by any pass", graph->resources[r].name);
+    }
+
+    graph->compiled = true;
+    return true;
+}
+
+// Get the real render target behind a resource handle (valid after compiling)
+// NOTE: resources not used by any pass have no target, an empty one (id 0) is returned
+RenderTexture2D GetGraphTarget(const RenderGraph *graph, int resource)
+{
+    if ((resource < 0) || (resource >= graph->resourceCount) || (graph->resources[resource].physical < 0)) return (RenderTexture2D){ 0 };
+
+    return graph->targets[graph->resources[resource].physical];
+}
+
+void ExecuteRenderGraph(RenderGraph *graph)
+{
+    if (!graph->compiled && !CompileRenderGraph(graph)) return;
+
+    for (int n = 0; n < graph->passCount; n++)
+    {
+        RGPass *pass = &graph->passes[graph->order[n]];
+        pass->execute(graph, pass, pass->userData);
+    }
+}
+
+void UnloadRenderGraph(RenderGraph *graph)
+{
+    for (int t = 0; t < graph->targetCount; t++) UnloadRenderTexture(graph->targets[t]);
+    graph->targetCount = 0;
+    graph->compiled = false;
+}
+
+void PrintRenderGraph(const RenderGraph *graph)
+{
+    int logicalBytes = 0, physicalBytes = 0;
+
+    printf("RENDERGRAPH: execution order:\n");
+    for (int n = 0; n < graph->passCount; n++) printf("    %i: %s\n", n, graph->passes[graph->order[n]].name);
+
+    for (int r = 0; r < graph->resourceCount; r++)
+    {
+        const RGResource *res = &graph->resources[r];
+        printf("    resource %-8s passes [%i..%i] -> target %i\n", res->name, res->firstPass, res->lastPass, res->physical);
+        if (res->physical >= 0) logicalBytes += res->width*res->height*4;
+    }
+    for (int t = 0; t < graph->targetCount; t++) physicalBytes += graph->targets[t].texture.width*graph->targets[t].texture.height*4;
+
+    printf("RENDERGRAPH: %i resources on %i targets, colour memory %.2f MB instead of %.2f MB\n",
+        graph->resourceCount, graph->targetCount, physicalBytes/(1024.0f*1024.0f), logicalBytes/(1024.0f*1024.0f));
+}
+
+//----------------------------------------------------------------------------------
+// Example passes (a simple bloom)
+//----------------------------------------------------------------------------------
+const char* brightShaderSrc="#version 330\n"
+"in vec2 fragTexCoord;\n"
+"in vec4 fragColor;\n"
+"uniform sampler2D texture0;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    vec3 c = texture(texture0, fragTexCoord).rgb;\n"
+"    float luma = dot(c, vec3(0.299, 0.587, 0.114));\n"
+"    finalColor = vec4(c*smoothstep(0.6, 0.9, luma), 1.0);\n"
+"}\n";
+
+const char* blurShaderSrc="#version 330\n"
+"in vec2 fragTexCoord;\n"
+"in vec4 fragColor;\n"
+"uniform sampler2D texture0;\n"
+"uniform vec2 direction;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    vec2 texel = direction/vec2(textureSize(texture0, 0));\n"
+"    vec3 sum = texture(texture0, fragTexCoord).rgb*0.227;\n"
+"    sum += texture(texture0, fragTexCoord + texel*1.384).rgb*0.316;\n"
+"    sum += texture(texture0, fragTexCoord - texel*1.384).rgb*0.316;\n"
+"    sum += texture(texture0, fragTexCoord + texel*3.230).rgb*0.070;\n"
+"    sum += texture(texture0, fragTexCoord - texel*3.230).rgb*0.070;\n"
+"    finalColor = vec4(sum, 1.0);\n"
+"}\n";
+
+typedef struct BloomData {
+    int scene, bright, blurH, blurV;    // resource handles
+    Shader brightShader;
+    Shader blurShader;
+    int directionLoc;
+    float time;
+} BloomData;
+
+// Draw a whole render target texture (flipped, as render textures are stored upside down)
+static void DrawTargetFullscreen(RenderTexture2D src, int width, int height)
+{
+    DrawTexturePro(src.texture, (Rectangle){ 0, 0, (float)src.texture.width, (float)-src.texture.height },
+        (Rectangle){ 0, 0, (float)width, (float)height }, (Vector2){ 0, 0 }, 0, WHITE);
+}
+
+static void ScenePass(RenderGraph *graph, RGPass *pass, void *userData)
+{
+    BloomData *data = (BloomData *)userData;
+    (void)pass;
+    RenderTexture2D dst = GetGraphTarget(graph, data->scene);
+
+    BeginTextureMode(dst);
+        ClearBackground(BLACK);
+        for (int i = 0; i < 12; i++)
+        {
+            float a = data->time + i*PI/6.0f;
+            DrawCircle(dst.texture.width/2 + (int)(cosf(a)*220), dst.texture.height/2 + (int)(sinf(a)*140), 18, (i%3 == 0)? WHITE : DARKBLUE);
+        }
+        DrawRectangle(60, 60, 120, 40, GOLD);
+    EndTextureMode();
+}
+
+static void BrightPass(RenderGraph *graph, RGPass *pass, void *userData)
+{
+    BloomData *data = (BloomData *)userData;
+    (void)pass;
+    RenderTexture2D dst = GetGraphTarget(graph, data->bright);
+
+    BeginTextureMode(dst);
+        ClearBackground(BLACK);
+        BeginShaderMode(data->brightShader);
+            DrawTargetFullscreen(GetGraphTarget(graph, data->scene), dst.texture.width, dst.texture.height);
+        EndShaderMode();
+    EndTextureMode();
+}
+
+static void BlurPass(RenderGraph *graph, RGPass *pass, void *userData)
+{
+    BloomData *data = (BloomData *)userData;
+    bool horizontal = (pass->writes[0] == data->blurH);
+    RenderTexture2D src = GetGraphTarget(graph, pass->reads[0]);
+    RenderTexture2D dst = GetGraphTarget(graph, pass->writes[0]);
+    Vector2 direction = horizontal? (Vector2){ 1.0f, 0.0f } : (Vector2){ 0.0f, 1.0f };
+
+    BeginTextureMode(dst);
+        ClearBackground(BLACK);
+        BeginShaderMode(data->blurShader);
+            SetShaderValue(data->blurShader, data->directionLoc, &direction, SHADER_UNIFORM_VEC2);
+            DrawTargetFullscreen(src, dst.texture.width, dst.texture.height);
+        EndShaderMode();
+    EndTextureMode();
+}
+
+static void CompositePass(RenderGraph *graph, RGPass *pass, void *userData)
+{
+    BloomData *data = (BloomData *)userData;
+    (void)pass;
+
+    DrawTargetFullscreen(GetGraphTarget(graph, data->scene), GetScreenWidth(), GetScreenHeight());
+    BeginBlendMode(BLEND_ADDITIVE);
+        DrawTargetFullscreen(GetGraphTarget(graph, data->blurV), GetScreenWidth(), GetScreenHeight());
+    EndBlendMode();
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    // -------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - render graph");
+
+    BloomData bloom = { 0 };
+    bloom.brightShader = LoadShaderFromMemory(0, brightShaderSrc);
+    bloom.blurShader = LoadShaderFromMemory(0, blurShaderSrc);
+    bloom.directionLoc = GetShaderLocation(bloom.blurShader, "direction");
+
+    RenderGraph graph = { 0 };
+    bloom.scene = AddGraphResource(&graph, "scene", screenWidth, screenHeight);
+    bloom.bright = AddGraphResource(&graph, "bright", screenWidth/2, screenHeight/2);
+    bloom.blurH = AddGraphResource(&graph, "blurH", screenWidth/2, screenHeight/2);
+    bloom.blurV = AddGraphResource(&graph, "blurV", screenWidth/2, screenHeight/2);
+
+    // declared out of order, the graph sorts them from their reads and writes
+    RGPass *pass = AddGraphPass(&graph, "composite", CompositePass, &bloom);
+    GraphPassRead(pass, bloom.scene);
+    GraphPassRead(pass, bloom.blurV);
+    GraphPassWrite(pass, RG_BACKBUFFER);
+
+    pass = AddGraphPass(&graph, "blur vertical", BlurPass, &bloom);
+    GraphPassRead(pass, bloom.blurH);
+    GraphPassWrite(pass, bloom.blurV);
+
+    pass = AddGraphPass(&graph, "blur horizontal", BlurPass, &bloom);
+    GraphPassRead(pass, bloom.bright);
+    GraphPassWrite(pass, bloom.blurH);
+
+    pass = AddGraphPass(&graph, "bright", BrightPass, &bloom);
+    GraphPassRead(pass, bloom.scene);
+    GraphPassWrite(pass, bloom.bright);
+
+    pass = AddGraphPass(&graph, "scene", ScenePass, &bloom);
+    GraphPassWrite(pass, bloom.scene);
+
+    CompileRenderGraph(&graph);
+    PrintRenderGraph(&graph);
+
+    SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
+    //---------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        bloom.time += GetFrameTime();
+
+        // Draw
+        // ---------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(BLACK);
+
+            ExecuteRenderGraph(&graph);
+
+            DrawText(TextFormat("%i render targets declared, %i allocated", graph.resourceCount, graph.targetCount), 10, 40, 20, LIGHTGRAY);
+            DrawFPS(10, 10);
+
+        EndDrawing();
+        // -----------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadRenderGraph(&graph);
+    UnloadShader(bloom.brightShader);
+    UnloadShader(bloom.blurShader);
+
+    CloseWindow();          // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
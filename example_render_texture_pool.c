@@ -0,0 +1,229 @@
+/*******************************************************************************************
+*
+*   raylib example - render texture pool keyed by size and format
+*
+*   Effects that need temporary render targets every frame acquire them from a pool and
+*   release them when done, instead of creating and deleting FBOs and textures.
+*   Targets are matched by (width, height, colour format, depth/stencil format) so after
+*   the first frame no GL objects are created at all.
+*   Free targets not used for a while, or beyond the pool's memory budget, are evicted
+*   (least recently used first).
+*
+*   Press 1, 2, 3 to change the resolution of the temporary targets and see the old
+*   ones being evicted.
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+#include "function_RenderTextureDepth.c"          // Required for: RenderTextureDepthFormat, LoadRenderTextureDepth()
+
+#define MAX_POOLED_TARGETS      32
+#define POOL_EVICT_AFTER_FRAMES 120     // free targets unused for this long are deleted
+
+typedef struct PooledTarget {
+    RenderTexture2D target;
+    int colorFormat;
+    int depthFormat;
+    int bytes;                          // approximate VRAM used
+    bool inUse;
+    int lastUsedFrame;
+} PooledTarget;
+
+typedef struct RenderTexturePool {
+    PooledTarget entries[MAX_POOLED_TARGETS];
+    int count;
+    int frame;
+    int budgetBytes;                    // free targets are evicted while the pool uses more than this
+    int totalBytes;
+
+    int allocations;                    // per-frame counters
+    int reuses;
+    int evictions;
+} RenderTexturePool;
+
+static void PoolEvict(RenderTexturePool *pool, int index)
+{
+    UnloadRenderTextureDepth(pool->entries[index].target, true);
+    pool->totalBytes -= pool->entries[index].bytes;
+    pool->entries[index] = pool->entries[--pool->count];
+    pool->evictions++;
+}
+
+// Evict free targets, least recently used first, until the pool fits in its budget
+static void PoolTrimToBudget(RenderTexturePool *pool)
+{
+    while (pool->totalBytes > pool->budgetBytes)
+    {
+        int oldest = -1;
+        for (int i = 0; i < pool->count; i++)
+        {
+            if (!pool->entries[i].inUse && ((oldest == -1) || (pool->entries[i].lastUsedFrame < pool->entries[oldest].lastUsedFrame))) oldest = i;
+        }
+
+        if (oldest == -1) break;        // everything is in use, nothing we can do
+        PoolEvict(pool, oldest);
+    }
+}
+
+void InitRenderTexturePool(RenderTexturePool *pool, int budgetBytes)
+{
+    *pool = (RenderTexturePool){ 0 };
+    pool->budgetBytes = budgetBytes;
+}
+
+// Get a render target with the requested size and formats, reusing a free one if possible
+// NOTE: contents of a reused target are undefined, clear it before drawing
+RenderTexture2D AcquireRenderTexture(RenderTexturePool *pool, int width, int height, int colorFormat, int depthFormat)
+{
+    for (int i = 0; i < pool->count; i++)
+    {
+        PooledTarget *e = &pool->entries[i];
+        if (!e->inUse && (e->target.texture.width == width) && (e->target.texture.height == height) &&
+            (e->colorFormat == colorFormat) && (e->depthFormat == depthFormat))
+        {
+            e->inUse = true;
+            e->lastUsedFrame = pool->frame;
+            pool->reuses++;
+            return e->target;
+        }
+    }
+
+    if (pool->count >= MAX_POOLED_TARGETS)
+    {
+        TRACELOG(LOG_WARNING, "POOL: No free render texture slots, increase MAX_POOLED_TARGETS");
+        return (RenderTexture2D){ 0 };
+    }
+
+    PooledTarget *e = &pool->entries[pool->count++];
+    e->target = LoadRenderTextureDepth(width, height, colorFormat, depthFormat);
+    e->colorFormat = colorFormat;
+    e->depthFormat = depthFormat;
+    e->bytes = GetPixelDataSize(width, height, colorFormat) + ((depthFormat != RT_DEPTH_NONE)? width*height*4 : 0);
+    e->inUse = true;
+    e->lastUsedFrame = pool->frame;
+
+    pool->totalBytes += e->bytes;
+    pool->allocations++;
+
+    // Trimming can swap-remove entries, e may point to another target afterwards
+    RenderTexture2D target = e->target;
+    PoolTrimToBudget(pool);
+
+    return target;
+}
+
+// Give a target back to the pool, it stays allocated for later Acquire calls
+void ReleaseRenderTexture(RenderTexturePool *pool, RenderTexture2D target)
+{
+    for (int i = 0; i < pool->count; i++)
+    {
+        if (pool->entries[i].target.id == target.id)
+        {
+            pool->entries[i].inUse = false;
+            pool->entries[i].lastUsedFrame = pool->frame;
+            return;
+        }
+    }
+
+    TRACELOG(LOG_WARNING, "POOL: [ID %i] Released render texture does not belong to the pool", target.id);
+}
+
+// Call once per frame: evicts targets not used recently and resets the counters
+void UpdateRenderTexturePool(RenderTexturePool *pool)
+{
+    pool->frame++;
+    pool->allocations = 0;
+    pool->reuses = 0;
+    pool->evictions = 0;
+
+    for (int i = pool->count - 1; i >= 0; i--)
+    {
+        if (!pool->entries[i].inUse && (pool->frame - pool->entries[i].lastUsedFrame > POOL_EVICT_AFTER_FRAMES)) PoolEvict(pool, i);
+    }
+
+    PoolTrimToBudget(pool);
+}
+
+void UnloadRenderTexturePool(RenderTexturePool *pool)
+{
+    for (int i = 0; i < pool->count; i++) UnloadRenderTextureDepth(pool->entries[i].target, true);
+    pool->count = 0;
+    pool->totalBytes = 0;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    // -------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - render texture pool");
+
+    RenderTexturePool pool;
+    InitRenderTexturePool(&pool, 64*1024*1024);
+
+    float scale = 1.0f;
+    float phase = 0;
+
+    SetTargetFPS(60);
+    while (!WindowShouldClose())
+        {
+        phase += GetFrameTime();
+        if (IsKeyPressed(KEY_ONE)) scale = 1.0f;
+        if (IsKeyPressed(KEY_TWO)) scale = 0.5f;
+        if (IsKeyPressed(KEY_THREE)) scale = 0.25f;
+
+        int w = (int)(screenWidth*scale);
+        int h = (int)(screenHeight*scale);
+
+        // counters of the previous frame are shown, so read them before resetting
+        int allocations = pool.allocations, reuses = pool.reuses, evictions = pool.evictions;
+        UpdateRenderTexturePool(&pool);
+
+        BeginDrawing();
+        ClearBackground(BLACK);
+
+        // temporary target 1: the scene, with depth/stencil
+        RenderTexture2D scene = AcquireRenderTexture(&pool, w, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, RT_DEPTH_24_STENCIL_8);
+        BeginTextureMode(scene);
+        ClearBackground(DARKBLUE);
+        for (int i = 0; i < 8; i++) DrawCircle((int)(w/2 + cosf(phase + i)*w/3), (int)(h/2 + sinf(phase*1.3f + i)*h/3), 20*scale, ORANGE);
+        EndTextureMode();
+
+        // temporary target 2: a tinted copy, no depth needed
+        RenderTexture2D tinted = AcquireRenderTexture(&pool, w, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, RT_DEPTH_NONE);
+        BeginTextureMode(tinted);
+        ClearBackground(BLACK);
+        DrawTexturePro(scene.texture, (Rectangle){0,0,w,-h}, (Rectangle){0,0,w,h}, (Vector2){0,0}, 0, (Color){255,220,200,255});
+        EndTextureMode();
+        ReleaseRenderTexture(&pool, scene);
+
+        DrawTexturePro(tinted.texture, (Rectangle){0,0,w,-h}, (Rectangle){0,0,screenWidth,screenHeight}, (Vector2){0,0}, 0, WHITE);
+
+        DrawText("Press 1, 2, 3 to change the temporary target resolution",10,40,20,WHITE);
+        DrawText(TextFormat("Pool: %i targets, %.1f MB", pool.count, pool.totalBytes/(1024.0f*1024.0f)),10,70,20,WHITE);
+        DrawText(TextFormat("Last frame: %i allocations, %i reuses, %i evictions", allocations, reuses, evictions),10,100,20,WHITE);
+        DrawFPS(10,10);
+
+        EndDrawing();
+
+        // released after EndDrawing() since the batch draws it only when flushed
+        ReleaseRenderTexture(&pool, tinted);
+        }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadRenderTexturePool(&pool);
+    CloseWindow();          // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
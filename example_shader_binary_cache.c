@@ -0,0 +1,405 @@
+/*******************************************************************************************
+*
+*   raylib example - on-disk shader program binary cache
+*
+*   Compiling GLSL at startup is slow when there are many shaders. After a program is
+*   linked once, its driver binary is saved with glGetProgramBinary() and loaded back on
+*   the next run with glProgramBinary(), skipping compilation completely.
+*
+*   Cache files are named after a hash of the shader sources plus GL vendor, renderer and
+*   version strings, so a driver update or a different GPU simply misses the cache.
+*   If the driver rejects a binary (GL_LINK_STATUS false) the file is deleted and the
+*   program is compiled from source again.
+*
+*   NOTE: requires OpenGL 4.1 or GL_ARB_get_program_binary (GL_NUM_PROGRAM_BINARY_FORMATS > 0)
+*   NOTE: some drivers keep their own shader cache too, so the very first run after a
+*         driver install is the real "cold" number
+*
+*   Run the example twice: the first run prints the cold (compile) time, the second the
+*   warm (cached) time. Press R to clear the cache and reload, W to reload from cache.
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "external/glad.h"
+#include "rlgl.h"
+
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION     "vertexPosition"    // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD     "vertexTexCoord"    // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL       "vertexNormal"      // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR        "vertexColor"       // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT      "vertexTangent"     // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT
+#define RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2    "vertexTexCoord2"   // Bound by default to shader location: RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_MVP         "mvp"               // model-view-projection matrix
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_VIEW        "matView"           // view matrix
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_PROJECTION  "matProjection"     // projection matrix
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_MODEL       "matModel"          // model matrix
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_NORMAL      "matNormal"         // normal matrix (transpose(inverse(matModelView))
+#define RL_DEFAULT_SHADER_UNIFORM_NAME_COLOR       "colDiffuse"        // color diffuse (base tint color, multiplied by texture color)
+#define RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE0  "texture0"          // texture0 (texture slot active 0)
+#define RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE1  "texture1"          // texture1 (texture slot active 1)
+#define RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE2  "texture2"          // texture2 (texture slot active 2)
+
+// Same attribute locations rlLoadShaderProgram() binds before linking
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION    0
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD    1
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL      2
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR       3
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_TANGENT     4
+#define RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2   5
+
+#define SHADER_CACHE_DIR        "shader_cache"
+#define SHADER_CACHE_MAGIC      0x48534c52      // "RLSH"
+#define NUM_TEST_PROGRAMS       48
+
+typedef struct ShaderCacheHeader {
+    unsigned int magic;
+    unsigned int binaryFormat;
+    int binaryLength;
+} ShaderCacheHeader;
+
+int cacheHits = 0;
+int cacheMisses = 0;
+
+// FNV-1a 64 bit, continued from a previous hash value
+static unsigned long long HashString(unsigned long long hash, const char *text)
+{
+    if (text == NULL) text = "(null)";
+    while (*text) { hash ^= (unsigned char)*text++; hash *= 1099511628211ull; }
+    return hash ^ 0xff;         // separator, so ("ab","c") and ("a","bc") hash differently
+}
+
+// Cache file name for a set of sources on the current driver
+static const char *GetShaderCacheFileName(const char *vsCode, const char *gsCode, const char *fsCode)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    hash = HashString(hash, (const char *)glGetString(GL_VENDOR));
+    hash = HashString(hash, (const char *)glGetString(GL_RENDERER));
+    hash = HashString(hash, (const char *)glGetString(GL_VERSION));
+    hash = HashString(hash, vsCode);
+    hash = HashString(hash, gsCode);
+    hash = HashString(hash, fsCode);
+
+    return TextFormat("%s/%016llx.bin", SHADER_CACHE_DIR, hash);
+}
+
+static bool IsProgramLinked(unsigned int id)
+{
+    GLint success = 0;
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+    return (success == GL_TRUE);
+}
+
+static unsigned int CompileStage(const char *shaderCode, int type)
+{
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &shaderCode, NULL);
+    glCompileShader(shader);
+
+    GLint success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        printf("SHADER: [ID %i] Compile error: %s\n", shader, log);
+        glDeleteShader(shader);
+        shader = 0;
+    }
+
+    return shader;
+}
+
+// Compile and link from source, asking the driver to keep the binary retrievable
+static unsigned int LinkProgramFromSource(const char *vsCode, const char *gsCode, const char *fsCode)
+{
+    unsigned int stages[3] = { 0 };
+    int stageCount = 0;
+
+    if (vsCode != NULL) stages[stageCount++] = CompileStage(vsCode, GL_VERTEX_SHADER);
+    if (gsCode != NULL) stages[stageCount++] = CompileStage(gsCode, GL_GEOMETRY_SHADER);
+    if (fsCode != NULL) stages[stageCount++] = CompileStage(fsCode, GL_FRAGMENT_SHADER);
+
+    unsigned int id = glCreateProgram();
+    for (int i = 0; i < stageCount; i++) if (stages[i] > 0) glAttachShader(id, stages[i]);
+
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION);
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD);
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL);
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR);
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TANGENT, RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT);
+    glBindAttribLocation(id, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2);
+
+    glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(id);
+
+    for (int i = 0; i < stageCount; i++)
+    {
+        if (stages[i] > 0)
+        {
+            glDetachShader(id, stages[i]);
+            glDeleteShader(stages[i]);
+        }
+    }
+
+    if (!IsProgramLinked(id))
+    {
+        char log[1024] = { 0 };
+        glGetProgramInfoLog(id, sizeof(log), NULL, log);
+        printf("SHADER: [ID %i] Link error: %s\n", id, log);
+        glDeleteProgram(id);
+        id = 0;
+    }
+
+    return id;
+}
+
+// Try to create the program from a cached binary, 0 if there is none or the driver rejects it
+static unsigned int LoadProgramFromCache(const char *fileName)
+{
+    if (!FileExists(fileName)) return 0;
+
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(fileName, &dataSize);
+    if (data == NULL) return 0;
+
+    unsigned int id = 0;
+    ShaderCacheHeader header = { 0 };
+    if (dataSize > (int)sizeof(ShaderCacheHeader)) memcpy(&header, data, sizeof(ShaderCacheHeader));
+
+    if ((header.magic == SHADER_CACHE_MAGIC) && (header.binaryLength == dataSize - (int)sizeof(ShaderCacheHeader)))
+    {
+        id = glCreateProgram();
+        glProgramBinary(id, header.binaryFormat, data + sizeof(ShaderCacheHeader), header.binaryLength);
+
+        if (!IsProgramLinked(id))
+        {
+            glDeleteProgram(id);
+            id = 0;
+        }
+    }
+
+    UnloadFileData(data);
+
+    if (id == 0)
+    {
+        TRACELOG(LOG_WARNING, "SHADER: Cached binary %s rejected, compiling from source", fileName);
+        remove(fileName);
+    }
+
+    return id;
+}
+
+static void SaveProgramToCache(unsigned int id, const char *fileName)
+{
+    GLint length = 0;
+    glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    unsigned char *data = (unsigned char *)RL_MALLOC(sizeof(ShaderCacheHeader) + length);
+    ShaderCacheHeader header = { SHADER_CACHE_MAGIC, 0, 0 };
+    GLenum format = 0;
+
+    glGetProgramBinary(id, length, &header.binaryLength, &format, data + sizeof(ShaderCacheHeader));
+    header.binaryFormat = format;
+    memcpy(data, &header, sizeof(ShaderCacheHeader));
+
+    if (!DirectoryExists(SHADER_CACHE_DIR)) MakeDirectory(SHADER_CACHE_DIR);
+    SaveFileData(fileName, data, sizeof(ShaderCacheHeader) + header.binaryLength);
+
+    RL_FREE(data);
+}
+
+// Load shader from code strings (geometry shader optional), using the binary cache when possible
+Shader LoadShaderCached(const char *vsCode, const char *gsCode, const char *fsCode)
+{
+    Shader shader = { 0 };
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+    const char *fileName = GetShaderCacheFileName(vsCode, gsCode, fsCode);
+    char cacheFile[256] = { 0 };
+    strncpy(cacheFile, fileName, sizeof(cacheFile) - 1);     // TextFormat() buffers get reused
+
+    if (numFormats > 0) shader.id = LoadProgramFromCache(cacheFile);
+
+    if (shader.id > 0) cacheHits++;
+    else
+    {
+        cacheMisses++;
+        shader.id = LinkProgramFromSource(vsCode, gsCode, fsCode);
+        if ((shader.id > 0) && (numFormats > 0)) SaveProgramToCache(shader.id, cacheFile);
+    }
+
+    // After shader loading, we TRY to set default location names
+    if (shader.id > 0)
+    {
+        shader.locs = (int *)RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int));
+        for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+
+        // Get handles to GLSL input attribute locations
+        shader.locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION);
+        shader.locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD);
+        shader.locs[SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2);
+        shader.locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL);
+        shader.locs[SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT);
+        shader.locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(shader.id, RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR);
+
+        // Get handles to GLSL uniform locations (vertex shader)
+        shader.locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_MVP);
+        shader.locs[SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_VIEW);
+        shader.locs[SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_PROJECTION);
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_MODEL);
+        shader.locs[SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_NORMAL);
+
+        // Get handles to GLSL uniform locations (fragment shader)
+        shader.locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_UNIFORM_NAME_COLOR);
+        shader.locs[SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE0);  // SHADER_LOC_MAP_ALBEDO
+        shader.locs[SHADER_LOC_MAP_SPECULAR] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE1); // SHADER_LOC_MAP_METALNESS
+        shader.locs[SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform(shader.id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE2);
+    }
+
+    return shader;
+}
+
+// Delete every cached binary
+void ClearShaderCache(const char **fileNames, int count)
+{
+    for (int i = 0; i < count; i++) remove(fileNames[i]);
+}
+
+//----------------------------------------------------------------------------------
+// Test shaders: the fragment shader is specialised with a #define, so each of the
+// NUM_TEST_PROGRAMS programs is a different program for the driver and for the cache
+//----------------------------------------------------------------------------------
+const char* vertexShaderSrc=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"in vec3 vertexNormal;\n"
+"uniform mat4 mvp;\n"
+"out vec3 fragNormal;\n"
+"void main()\n"
+"{\n"
+"    fragNormal = vertexNormal;\n"
+"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+"}\n";
+
+const char* fragmentShaderTemplate=
+"#version 330\n"
+"#define VARIANT %i\n"
+"in vec3 fragNormal;\n"
+"uniform vec4 colDiffuse;\n"
+"out vec4 finalColor;\n"
+"void main()\n"
+"{\n"
+"    vec3 n = normalize(fragNormal);\n"
+"    float v = 0.0;\n"
+"    for (int i = 0; i < 8 + VARIANT; i++) v += sin(dot(n, vec3(i, VARIANT, 1.0)))*0.1;\n"
+"    finalColor = vec4(0.5 + 0.5*n*cos(v + float(VARIANT)), 1.0)*colDiffuse;\n"
+"}\n";
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - shader binary cache");
+
+    char *fragmentSources[NUM_TEST_PROGRAMS];
+    char *cacheFiles[NUM_TEST_PROGRAMS];
+    for (int i = 0; i < NUM_TEST_PROGRAMS; i++)
+    {
+        fragmentSources[i] = (char *)RL_MALLOC(strlen(fragmentShaderTemplate) + 16);
+        sprintf(fragmentSources[i], fragmentShaderTemplate, i);
+        cacheFiles[i] = (char *)RL_CALLOC(256, 1);
+        strncpy(cacheFiles[i], GetShaderCacheFileName(vertexShaderSrc, NULL, fragmentSources[i]), 255);
+    }
+
+    Shader shaders[NUM_TEST_PROGRAMS] = { 0 };
+    bool reload = true;
+    double loadTime = 0;
+
+    Model model = LoadModelFromMesh(GenMeshKnot(1.0f, 2.0f, 64, 64));
+
+    Camera3D camera = { 0 };
+    camera.fovy = 45;
+    camera.position = (Vector3){ 0, 3, 8 };
+    camera.target = (Vector3){ 0, 0, 0 };
+    camera.up = (Vector3){ 0, 1, 0 };
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        if (IsKeyPressed(KEY_R))
+        {
+            ClearShaderCache((const char **)cacheFiles, NUM_TEST_PROGRAMS);
+            reload = true;
+        }
+        if (IsKeyPressed(KEY_W)) reload = true;
+
+        if (reload)
+        {
+            for (int i = 0; i < NUM_TEST_PROGRAMS; i++) if (shaders[i].id > 0) UnloadShader(shaders[i]);
+
+            cacheHits = 0;
+            cacheMisses = 0;
+
+            double start = GetTime();
+            for (int i = 0; i < NUM_TEST_PROGRAMS; i++) shaders[i] = LoadShaderCached(vertexShaderSrc, NULL, fragmentSources[i]);
+            glFinish();     // make sure the driver really finished with all the programs
+            loadTime = GetTime() - start;
+
+            printf("SHADER CACHE: %i programs loaded in %.2f ms (%i from cache, %i compiled) - %s start\n",
+                NUM_TEST_PROGRAMS, loadTime*1000.0, cacheHits, cacheMisses, (cacheMisses == 0)? "WARM" : "COLD");
+            reload = false;
+        }
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+            ClearBackground(DARKGRAY);
+
+            BeginMode3D(camera);
+                Shader shader = shaders[(int)(GetTime()*2.0)%NUM_TEST_PROGRAMS];
+                if (shader.id == 0) shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };    // failed to load
+                model.materials[0].shader = shader;
+                DrawModel(model, (Vector3){ 0, 0, 0 }, 1.0f, WHITE);
+            EndMode3D();
+
+            DrawText(TextFormat("%i programs loaded in %.2f ms (%i cached, %i compiled)",
+                NUM_TEST_PROGRAMS, loadTime*1000.0, cacheHits, cacheMisses), 20, 40, 20, WHITE);
+            DrawText("R = clear cache and reload (cold), W = reload (warm)", 20, 70, 20, WHITE);
+            DrawFPS(20, 10);
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    model.materials[0].shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };    // our shaders are unloaded below
+    UnloadModel(model);
+    for (int i = 0; i < NUM_TEST_PROGRAMS; i++)
+    {
+        if (shaders[i].id > 0) UnloadShader(shaders[i]);
+        RL_FREE(fragmentSources[i]);
+        RL_FREE(cacheFiles[i]);
+    }
+
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -0,0 +1,366 @@
+/*******************************************************************************************
+*
+*   raylib example - shader reflection and uniform location cache
+*
+*   After linking, every active uniform and attribute of the program is enumerated once
+*   (glGetActiveUniform / glGetActiveAttrib) and stored in a small hash table.
+*   Lookups by name are done only at load time and return a handle (index) that is
+*   used inside the main loop, so no string lookups happen per frame.
+*   Every uniform also keeps a copy of the last value uploaded to it and uploads
+*   that would not change anything are skipped.
+*
+*   Same 6 textures shader as in example_non-batched_quad_with_shader.c
+*
+********************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>                     // Required for: memcmp(), memcpy(), strncpy(), strlen()
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+#define MAX_REFLECTED_UNIFORMS      64
+#define MAX_REFLECTED_ATTRIBS       16
+#define MAX_REFLECTED_NAME          64
+#define REFLECTION_HASH_SIZE        128      // power of two, at least 2x MAX_REFLECTED_UNIFORMS
+#define MAX_UNIFORM_CACHE_BYTES     64       // enough for one mat4, bigger arrays are never cached
+
+typedef struct ReflectedUniform {
+    char name[MAX_REFLECTED_NAME];
+    unsigned int hash;
+    int location;
+    unsigned int glType;                 // GL_FLOAT_VEC4, GL_SAMPLER_2D, ...
+    int arraySize;
+    bool cacheValid;
+    int cacheBytes;
+    unsigned char cache[MAX_UNIFORM_CACHE_BYTES];   // last value uploaded to this uniform
+} ReflectedUniform;
+
+typedef struct ReflectedAttrib {
+    char name[MAX_REFLECTED_NAME];
+    int location;
+    unsigned int glType;
+} ReflectedAttrib;
+
+typedef struct ShaderReflection {
+    unsigned int programId;
+    int uniformCount;
+    ReflectedUniform uniforms[MAX_REFLECTED_UNIFORMS];
+    int attribCount;
+    ReflectedAttrib attribs[MAX_REFLECTED_ATTRIBS];
+    short hashTable[REFLECTION_HASH_SIZE];          // uniform index + 1, 0 = empty slot
+
+    int uploadsIssued;                  // per-frame counters
+    int uploadsSkipped;
+} ShaderReflection;
+
+const char* vs2="#version 330 core              \n"
+"layout (location = 0) in vec3 vertexPosition;\n"
+"layout (location = 1) in vec2 vertexTexCoord;\n"
+"out vec2 texCoord;\n"
+"void main() {\n"
+"    gl_Position = vec4(vertexPosition, 1.0);\n"
+"    texCoord = vertexTexCoord;\n"
+"}\n\0";
+
+const char* fs2="#version 330 core              \n"
+"out vec4 finalColor;\n"
+"in vec2 texCoord;\n"
+"uniform sampler2D mytexture0;\n"
+"uniform sampler2D mytexture1;\n"
+"uniform sampler2D mytexture2;\n"
+"uniform sampler2D mytexture3;\n"
+"uniform sampler2D mytexture4;\n"
+"uniform sampler2D mytexture5;\n"
+"uniform float tex_select;\n"
+"void main() {\n"
+"finalColor = vec4(1.0);\n"
+"    if (tex_select==0.0) finalColor = texture(mytexture0, texCoord);\n"
+"    if (tex_select==1.0) finalColor = texture(mytexture1, texCoord);\n"
+"    if (tex_select==2.0) finalColor = texture(mytexture2, texCoord);\n"
+"    if (tex_select==3.0) finalColor = texture(mytexture3, texCoord);\n"
+"    if (tex_select==4.0) finalColor = texture(mytexture4, texCoord);\n"
+"    if (tex_select==5.0) finalColor = texture(mytexture5, texCoord);\n"
+"}\n\0";
+
+// FNV-1a hash of a uniform name
+static unsigned int HashUniformName(const char *name)
+{
+    unsigned int hash = 2166136261u;
+    while (*name) { hash ^= (unsigned char)*name++; hash *= 16777619u; }
+    return hash;
+}
+
+// Size in bytes of one element of a rlgl uniform type
+static int GetUniformTypeSize(int uniformType)
+{
+    switch (uniformType)
+    {
+        case RL_SHADER_UNIFORM_FLOAT: return 4;
+        case RL_SHADER_UNIFORM_VEC2: return 8;
+        case RL_SHADER_UNIFORM_VEC3: return 12;
+        case RL_SHADER_UNIFORM_VEC4: return 16;
+        case RL_SHADER_UNIFORM_INT: return 4;
+        case RL_SHADER_UNIFORM_IVEC2: return 8;
+        case RL_SHADER_UNIFORM_IVEC3: return 12;
+        case RL_SHADER_UNIFORM_IVEC4: return 16;
+        case RL_SHADER_UNIFORM_SAMPLER2D: return 4;
+        default: return 0;
+    }
+}
+
+// Enumerate all active uniforms and attributes of a linked program
+// NOTE: call once after linking, the returned structure is used instead of name lookups
+ShaderReflection *LoadShaderReflection(unsigned int programId)
+{
+    ShaderReflection *refl = (ShaderReflection *)RL_CALLOC(1, sizeof(ShaderReflection));
+    refl->programId = programId;
+
+    GLint count = 0;
+    glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &count);
+    if (count > MAX_REFLECTED_UNIFORMS)
+    {
+        TRACELOG(LOG_WARNING, "SHADER: [ID %i] Only %i of %i active uniforms reflected", programId, MAX_REFLECTED_UNIFORMS, count);
+        count = MAX_REFLECTED_UNIFORMS;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        ReflectedUniform *u = &refl->uniforms[refl->uniformCount];
+        GLsizei nameLength = 0;
+        GLint arraySize = 0;
+        GLenum type = 0;
+        glGetActiveUniform(programId, i, MAX_REFLECTED_NAME, &nameLength, &arraySize, &type, u->name);
+
+        // Uniforms inside named blocks have no location, skip them
+        u->location = glGetUniformLocation(programId, u->name);
+        if (u->location < 0) continue;
+
+        // Arrays are reported as "name[0]", store them as "name" so both spellings work on lookup
+        if ((nameLength > 3) && (strcmp(u->name + nameLength - 3, "[0]") == 0)) u->name[nameLength - 3] = '\0';
+
+        u->glType = type;
+        u->arraySize = arraySize;
+        u->hash = HashUniformName(u->name);
+
+        // Insert into the open addressing table (linear probing)
+        unsigned int slot = u->hash & (REFLECTION_HASH_SIZE - 1);
+        while (refl->hashTable[slot] != 0) slot = (slot + 1) & (REFLECTION_HASH_SIZE - 1);
+        refl->hashTable[slot] = (short)(refl->uniformCount + 1);
+
+        refl->uniformCount++;
+    }
+
+    glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTES, &count);
+    if (count > MAX_REFLECTED_ATTRIBS) count = MAX_REFLECTED_ATTRIBS;
+
+    for (int i = 0; i < count; i++)
+    {
+        ReflectedAttrib *a = &refl->attribs[refl->attribCount];
+        GLint arraySize = 0;
+        GLenum type = 0;
+        glGetActiveAttrib(programId, i, MAX_REFLECTED_NAME, NULL, &arraySize, &type, a->name);
+        a->location = glGetAttribLocation(programId, a->name);
+        a->glType = type;
+        if (a->location >= 0) refl->attribCount++;      // built-ins like gl_VertexID have no location
+    }
+
+    TRACELOG(LOG_INFO, "SHADER: [ID %i] Reflected %i uniforms and %i attributes", programId, refl->uniformCount, refl->attribCount);
+
+    return refl;
+}
+
+void UnloadShaderReflection(ShaderReflection *refl)
+{
+    RL_FREE(refl);
+}
+
+// Get handle of a uniform by name, -1 if the uniform is not active in the program
+// NOTE: meant to be used at load time, the handle is then used in the main loop
+int GetReflectedUniform(const ShaderReflection *refl, const char *name)
+{
+    // Arrays are stored without "[0]", strip it from the key too so "name[0]" finds "name"
+    char key[MAX_REFLECTED_NAME];
+    strncpy(key, name, MAX_REFLECTED_NAME - 1);
+    key[MAX_REFLECTED_NAME - 1] = '\0';
+    int keyLength = (int)strlen(key);
+    if ((keyLength > 3) && (strcmp(key + keyLength - 3, "[0]") == 0)) key[keyLength - 3] = '\0';
+    name = key;
+
+    unsigned int hash = HashUniformName(name);
+    unsigned int slot = hash & (REFLECTION_HASH_SIZE - 1);
+
+    while (refl->hashTable[slot] != 0)
+    {
+        const ReflectedUniform *u = &refl->uniforms[refl->hashTable[slot] - 1];
+        if ((u->hash == hash) && (strcmp(u->name, name) == 0)) return refl->hashTable[slot] - 1;
+        slot = (slot + 1) & (REFLECTION_HASH_SIZE - 1);
+    }
+
+    TRACELOG(LOG_WARNING, "SHADER: [ID %i] Uniform %s not found", refl->programId, name);
+    return -1;
+}
+
+// Get location of an attribute by name, -1 if the attribute is not active in the program
+int GetReflectedAttrib(const ShaderReflection *refl, const char *name)
+{
+    for (int i = 0; i < refl->attribCount; i++)
+    {
+        if (strcmp(refl->attribs[i].name, name) == 0) return refl->attribs[i].location;
+    }
+    return -1;
+}
+
+// Upload uniform value by handle, skipped when the value equals the last one uploaded
+// NOTE: program must be bound (rlEnableShader) as for rlSetUniform
+void SetReflectedUniform(ShaderReflection *refl, int handle, const void *value, int uniformType, int count)
+{
+    if ((handle < 0) || (handle >= refl->uniformCount)) return;
+
+    ReflectedUniform *u = &refl->uniforms[handle];
+    int bytes = GetUniformTypeSize(uniformType)*count;
+
+    if (bytes <= MAX_UNIFORM_CACHE_BYTES)
+    {
+        if (u->cacheValid && (u->cacheBytes == bytes) && (memcmp(u->cache, value, bytes) == 0))
+        {
+            refl->uploadsSkipped++;
+            return;
+        }
+
+        memcpy(u->cache, value, bytes);
+        u->cacheBytes = bytes;
+        u->cacheValid = true;
+    }
+    else u->cacheValid = false;
+
+    rlSetUniform(u->location, value, uniformType, count);
+    refl->uploadsIssued++;
+}
+
+// Upload matrix uniform by handle, skipped when the matrix equals the last one uploaded
+void SetReflectedUniformMatrix(ShaderReflection *refl, int handle, Matrix mat)
+{
+    if ((handle < 0) || (handle >= refl->uniformCount)) return;
+
+    ReflectedUniform *u = &refl->uniforms[handle];
+
+    if (u->cacheValid && (u->cacheBytes == sizeof(Matrix)) && (memcmp(u->cache, &mat, sizeof(Matrix)) == 0))
+    {
+        refl->uploadsSkipped++;
+        return;
+    }
+
+    memcpy(u->cache, &mat, sizeof(Matrix));
+    u->cacheBytes = sizeof(Matrix);
+    u->cacheValid = true;
+
+    rlSetUniformMatrix(u->location, mat);
+    refl->uploadsIssued++;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    // -------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - shader reflection and uniform cache");
+
+    // Load shader and reflect it once
+    Shader shader_display = LoadShaderFromMemory(vs2,fs2);
+    ShaderReflection *refl = LoadShaderReflection(shader_display.id);
+
+    for (int i = 0; i < refl->uniformCount; i++)
+        printf("uniform %-16s location: %2i  type: 0x%04x  size: %i\n", refl->uniforms[i].name,
+            refl->uniforms[i].location, refl->uniforms[i].glType, refl->uniforms[i].arraySize);
+    for (int i = 0; i < refl->attribCount; i++)
+        printf("attrib  %-16s location: %2i  type: 0x%04x\n", refl->attribs[i].name,
+            refl->attribs[i].location, refl->attribs[i].glType);
+
+    // All name lookups happen here, the main loop only uses handles
+    int selectTexHandle = GetReflectedUniform(refl, "tex_select");
+    int samplerHandles[6];
+    for (int i = 0; i < 6; i++) samplerHandles[i] = GetReflectedUniform(refl, TextFormat("mytexture%i", i));
+
+    Color colors[6] = { RED, GREEN, BLUE, MAGENTA, ORANGE, GRAY };
+    Texture2D textures[6];
+    for (int i = 0; i < 6; i++)
+    {
+        Image tmp_image=GenImageColor(screenWidth,screenHeight,colors[i]);
+        textures[i]=LoadTextureFromImage(tmp_image);
+        UnloadImage(tmp_image);
+    }
+
+    SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
+    //---------------------------------------------------------------------------------------
+    float tex_select=0.0;
+    // Main game loop
+    while (!WindowShouldClose())
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+
+        // Check key inputs to switch between textures
+        if (IsKeyPressed(KEY_ONE))      tex_select=0.0;
+        if (IsKeyPressed(KEY_TWO))      tex_select=1.0;
+        if (IsKeyPressed(KEY_THREE))    tex_select=2.0;
+        if (IsKeyPressed(KEY_FOUR))    tex_select=3.0;
+        if (IsKeyPressed(KEY_FIVE))    tex_select=4.0;
+        if (IsKeyPressed(KEY_SIX))    tex_select=5.0;
+
+        refl->uploadsIssued = 0;
+        refl->uploadsSkipped = 0;
+
+        // Draw
+        // ---------------------------------------------------------------------------------
+        BeginDrawing();
+
+        rlClearScreenBuffers(); // Clear color & depth buffer
+
+        rlEnableShader(shader_display.id);
+
+        // setup shader uniforms (only the first frame and key presses really upload anything)
+        SetReflectedUniform(refl, selectTexHandle, &tex_select, RL_SHADER_UNIFORM_FLOAT, 1);
+
+        // activate OpenGL's texture units and link our shader's samplers to them
+        for (int i = 0; i < 6; i++)
+        {
+            rlActiveTextureSlot(i);
+            rlEnableTexture(textures[i].id);
+            SetReflectedUniform(refl, samplerHandles[i], &i, RL_SHADER_UNIFORM_INT, 1);
+        }
+
+        rlLoadDrawQuad();
+
+        EndShaderMode();
+
+        rlEnableColorBlend();
+        DrawText("Show textures (press key): [1][2][3][4][5][6]", 10, 70, 20, DARKGRAY);
+        DrawText(TextFormat("Uniform uploads this frame: %i issued, %i skipped",
+            refl->uploadsIssued, refl->uploadsSkipped), 10, 100, 20, DARKGRAY);
+
+        DrawFPS(10, 10);
+
+        EndDrawing();
+        // -----------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int i = 0; i < 6; i++) UnloadTexture(textures[i]);
+
+    UnloadShaderReflection(refl);
+    UnloadShader(shader_display);
+
+    CloseWindow();          // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
@@ -0,0 +1,360 @@
+/*******************************************************************************************
+*
+*   raylib example - shader variants specialised with #define keys
+*
+*   Shaders often carry constants that could be compile time values but are uniforms or
+*   hard-coded numbers (circle sides in the geometry shader, noise octaves in the grass,
+*   NR_LIGHTS in the deferred renderer). Here one template is kept per shader and a set
+*   of #define values (the key) produces a specialised program: loops over a constant
+*   count can be unrolled and branches on a constant disappear.
+*
+*   Variants are compiled lazily the first time a key is requested and cached by key,
+*   common ones can be prewarmed at load time to avoid a hitch on first use.
+*   Templates give every key a default with #ifndef so they also compile on their own.
+*   The locations of the uniforms named when creating the set are looked up once per
+*   variant, right after it is compiled, so the main loop never calls GetShaderLocation().
+*
+*   Keys: 1-4 number of lights, O noise octaves, S specular on/off
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "raylib.h"
+#include "rlgl.h"
+
+#define MAX_VARIANT_DEFINES     8
+#define MAX_SHADER_VARIANTS     64
+#define MAX_VARIANT_UNIFORMS    8
+
+typedef struct ShaderVariant {
+    int values[MAX_VARIANT_DEFINES];
+    unsigned int hash;
+    Shader shader;
+    int locs[MAX_VARIANT_UNIFORMS];     // locations of the set's uniformNames in this program
+} ShaderVariant;
+
+typedef struct ShaderVariantSet {
+    const char *vsTemplate;
+    const char *fsTemplate;
+    const char *defineNames[MAX_VARIANT_DEFINES];
+    int defineCount;
+    const char *uniformNames[MAX_VARIANT_UNIFORMS];
+    int uniformCount;
+
+    ShaderVariant variants[MAX_SHADER_VARIANTS];
+    int count;
+
+    int compiles;                       // statistics
+    int hits;
+    double lastCompileMs;
+} ShaderVariantSet;
+
+// FNV-1a over the define values
+static unsigned int HashVariantKey(const int *values, int count)
+{
+    unsigned int hash = 2166136261u;
+    const unsigned char *bytes = (const unsigned char *)values;
+    for (int i = 0; i < count*(int)sizeof(int); i++) hash = (hash ^ bytes[i])*16777619u;
+    return hash;
+}
+
+// Insert "#define NAME value" lines after the #version line of a template
+// NOTE: returned string must be freed with RL_FREE()
+static char *SpecializeShaderSource(const char *source, const char **names, const int *values, int count)
+{
+    if (source == NULL) return NULL;
+
+    const char *body = source;
+    if (strncmp(source, "#version", 8) == 0)
+    {
+        const char *eol = strchr(source, '\n');
+        body = (eol != NULL)? eol + 1 : source + strlen(source);
+    }
+
+    int headerLength = (int)(body - source);
+    int size = (int)strlen(source) + 1;
+    for (int i = 0; i < count; i++) size += (int)strlen(names[i]) + 24;
+
+    char *result = (char *)RL_MALLOC(size);
+    int length = 0;
+
+    memcpy(result, source, headerLength);
+    length += headerLength;
+    if ((headerLength > 0) && (result[headerLength - 1] != '\n')) result[length++] = '\n';
+
+    for (int i = 0; i < count; i++) length += sprintf(result + length, "#define %s %i\n", names[i], values[i]);
+    strcpy(result + length, body);
+
+    return result;
+}
+
+// Create a variant set, defineNames are the keys every variant gives a value for,
+// uniformNames the uniforms whose locations every variant caches when compiled
+// NOTE: templates and names are not copied, they must outlive the set
+ShaderVariantSet *LoadShaderVariantSet(const char *vsTemplate, const char *fsTemplate, const char **defineNames, int defineCount,
+                                       const char **uniformNames, int uniformCount)
+{
+    if (defineCount > MAX_VARIANT_DEFINES)
+    {
+        TRACELOG(LOG_WARNING, "SHADER: Too many variant defines (%i), increase MAX_VARIANT_DEFINES", defineCount);
+        return NULL;
+    }
+
+    if (uniformCount > MAX_VARIANT_UNIFORMS)
+    {
+        TRACELOG(LOG_WARNING, "SHADER: Too many variant uniforms (%i), increase MAX_VARIANT_UNIFORMS", uniformCount);
+        return NULL;
+    }
+
+    ShaderVariantSet *set = (ShaderVariantSet *)RL_CALLOC(1, sizeof(ShaderVariantSet));
+    set->vsTemplate = vsTemplate;
+    set->fsTemplate = fsTemplate;
+    set->defineCount = defineCount;
+    for (int i = 0; i < defineCount; i++) set->defineNames[i] = defineNames[i];
+    set->uniformCount = uniformCount;
+    for (int i = 0; i < uniformCount; i++) set->uniformNames[i] = uniformNames[i];
+
+    return set;
+}
+
+static ShaderVariant *FindShaderVariant(ShaderVariantSet *set, const int *values, unsigned int hash)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        ShaderVariant *v = &set->variants[i];
+        if ((v->hash == hash) && (memcmp(v->values, values, set->defineCount*sizeof(int)) == 0)) return v;
+    }
+
+    return NULL;
+}
+
+// Get the program for a key, compiling it the first time it is requested
+// locs (optional) receives the cached locations of the set's uniformNames, -1 when not active
+// NOTE: on failure (or a full cache) the default shader is returned
+Shader GetShaderVariant(ShaderVariantSet *set, const int *values, const int **locs)
+{
+    static const int noLocs[MAX_VARIANT_UNIFORMS] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+
+    unsigned int hash = HashVariantKey(values, set->defineCount);
+    ShaderVariant *variant = FindShaderVariant(set, values, hash);
+
+    if (variant != NULL)
+    {
+        set->hits++;
+        if (locs != NULL) *locs = variant->locs;
+        return variant->shader;
+    }
+
+    if (set->count >= MAX_SHADER_VARIANTS)
+    {
+        TRACELOG(LOG_WARNING, "SHADER: Variant cache full, increase MAX_SHADER_VARIANTS");
+        if (locs != NULL) *locs = noLocs;
+        return (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+    }
+
+    double start = GetTime();
+    char *vs = SpecializeShaderSource(set->vsTemplate, set->defineNames, values, set->defineCount);
+    char *fs = SpecializeShaderSource(set->fsTemplate, set->defineNames, values, set->defineCount);
+    Shader shader = LoadShaderFromMemory(vs, fs);
+    RL_FREE(vs);
+    RL_FREE(fs);
+    set->lastCompileMs = (GetTime() - start)*1000.0;
+    set->compiles++;
+
+    // failed variants are cached too (as the default shader), so they are not compiled every frame
+    variant = &set->variants[set->count++];
+    memcpy(variant->values, values, set->defineCount*sizeof(int));
+    variant->hash = hash;
+    variant->shader = shader;
+    for (int i = 0; i < MAX_VARIANT_UNIFORMS; i++) variant->locs[i] = (i < set->uniformCount)? GetShaderLocation(shader, set->uniformNames[i]) : -1;
+
+    if (locs != NULL) *locs = variant->locs;
+    return shader;
+}
+
+// Compile a list of variants ahead of time, keys are stored one after another
+void PrewarmShaderVariants(ShaderVariantSet *set, const int *keys, int keyCount)
+{
+    int hits = set->hits;
+    for (int i = 0; i < keyCount; i++) GetShaderVariant(set, keys + i*set->defineCount, NULL);
+    set->hits = hits;       // prewarming is not a cache hit
+}
+
+void UnloadShaderVariantSet(ShaderVariantSet *set)
+{
+    if (set == NULL) return;
+
+    for (int i = 0; i < set->count; i++)
+    {
+        if (set->variants[i].shader.id != rlGetShaderIdDefault()) UnloadShader(set->variants[i].shader);
+    }
+
+    RL_FREE(set);
+}
+
+//----------------------------------------------------------------------------------
+// Shader templates
+//----------------------------------------------------------------------------------
+const char* vertexShaderSrc=
+"#version 330\n"
+"in vec3 vertexPosition;\n"
+"in vec3 vertexNormal;\n"
+"uniform mat4 mvp;\n"
+"uniform mat4 matModel;\n"
+"out vec3 fragPosition;\n"
+"out vec3 fragNormal;\n"
+"void main()\n"
+"{\n"
+"    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0));\n"
+"    fragNormal = normalize(mat3(matModel)*vertexNormal);\n"
+"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+"}\n";
+
+const char* fragmentShaderSrc=
+"#version 330\n"
+"#ifndef NR_LIGHTS\n"
+"#define NR_LIGHTS 4\n"
+"#endif\n"
+"#ifndef OCTAVES\n"
+"#define OCTAVES 4\n"
+"#endif\n"
+"#ifndef SPECULAR\n"
+"#define SPECULAR 1\n"
+"#endif\n"
+"in vec3 fragPosition;\n"
+"in vec3 fragNormal;\n"
+"uniform vec3 lightPos[NR_LIGHTS];\n"
+"uniform vec3 lightColor[NR_LIGHTS];\n"
+"uniform vec3 viewPos;\n"
+"out vec4 finalColor;\n"
+"float rand(vec3 c) { return fract(sin(dot(c, vec3(12.9898, 78.233, 37.719)))*43758.5453); }\n"
+"float noise(vec3 p)\n"
+"{\n"
+"    vec3 i = floor(p); vec3 f = fract(p); f = f*f*(3.0 - 2.0*f);\n"
+"    return mix(mix(mix(rand(i), rand(i + vec3(1,0,0)), f.x), mix(rand(i + vec3(0,1,0)), rand(i + vec3(1,1,0)), f.x), f.y),\n"
+"               mix(mix(rand(i + vec3(0,0,1)), rand(i + vec3(1,0,1)), f.x), mix(rand(i + vec3(0,1,1)), rand(i + vec3(1,1,1)), f.x), f.y), f.z);\n"
+"}\n"
+"void main()\n"
+"{\n"
+"    float n = 0.0, amp = 0.5, freq = 2.0;\n"
+"    for (int o = 0; o < OCTAVES; o++) { n += amp*noise(fragPosition*freq); amp *= 0.5; freq *= 2.0; }\n"
+"    vec3 albedo = mix(vec3(0.2, 0.4, 0.8), vec3(0.9, 0.8, 0.6), n);\n"
+"    vec3 normal = normalize(fragNormal);\n"
+"    vec3 viewDir = normalize(viewPos - fragPosition);\n"
+"    vec3 lighting = albedo*0.1;\n"
+"    for (int i = 0; i < NR_LIGHTS; i++)\n"
+"    {\n"
+"        vec3 lightDir = normalize(lightPos[i] - fragPosition);\n"
+"        lighting += max(dot(normal, lightDir), 0.0)*albedo*lightColor[i];\n"
+"#if SPECULAR\n"
+"        vec3 halfway = normalize(lightDir + viewDir);\n"
+"        lighting += pow(max(dot(normal, halfway), 0.0), 32.0)*lightColor[i]*0.5;\n"
+"#endif\n"
+"    }\n"
+"    finalColor = vec4(lighting, 1.0);\n"
+"}\n";
+
+// Uniforms of the demo templates, order of the names given to LoadShaderVariantSet()
+typedef enum {
+    VARIANT_LOC_LIGHT_POS = 0,
+    VARIANT_LOC_LIGHT_COLOR,
+    VARIANT_LOC_VIEW_POS
+} VariantUniform;
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - shader variants");
+
+    const char *defines[] = { "NR_LIGHTS", "OCTAVES", "SPECULAR" };
+    const char *uniforms[] = { "lightPos", "lightColor", "viewPos" };      // indexed by VariantUniform
+    ShaderVariantSet *variants = LoadShaderVariantSet(vertexShaderSrc, fragmentShaderSrc, defines, 3, uniforms, 3);
+
+    // the variants the demo starts with, the rest are compiled on first use
+    const int prewarm[] = {
+        1, 4, 1,
+        2, 4, 1,
+        3, 4, 1,
+        4, 4, 1,
+    };
+    double start = GetTime();
+    PrewarmShaderVariants(variants, prewarm, 4);
+    printf("SHADER: %i variants prewarmed in %.2f ms\n", variants->compiles, (GetTime() - start)*1000.0);
+
+    int key[3] = { 4, 4, 1 };   // NR_LIGHTS, OCTAVES, SPECULAR
+
+    Vector3 lightPos[4] = { 0 };
+    Vector3 lightColor[4] = {
+        { 1.0f, 0.3f, 0.3f }, { 0.3f, 1.0f, 0.3f }, { 0.3f, 0.3f, 1.0f }, { 1.0f, 1.0f, 0.6f }
+    };
+
+    Model model = LoadModelFromMesh(GenMeshSphere(2.0f, 48, 48));
+
+    Camera3D camera = { 0 };
+    camera.fovy = 45;
+    camera.position = (Vector3){ 0, 2, 7 };
+    camera.target = (Vector3){ 0, 0, 0 };
+    camera.up = (Vector3){ 0, 1, 0 };
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        for (int i = 0; i < 4; i++) if (IsKeyPressed(KEY_ONE + i)) key[0] = i + 1;
+        if (IsKeyPressed(KEY_O)) key[1] = (key[1] % 8) + 1;
+        if (IsKeyPressed(KEY_S)) key[2] = !key[2];
+
+        float t = (float)GetTime();
+        for (int i = 0; i < 4; i++) lightPos[i] = (Vector3){ cosf(t + i*1.57f)*4.0f, 2.0f, sinf(t + i*1.57f)*4.0f };
+
+        const int *locs = NULL;
+        Shader shader = GetShaderVariant(variants, key, &locs);
+
+        // arrays are sized by NR_LIGHTS, so only key[0] lights exist in this variant
+        SetShaderValueV(shader, locs[VARIANT_LOC_LIGHT_POS], lightPos, SHADER_UNIFORM_VEC3, key[0]);
+        SetShaderValueV(shader, locs[VARIANT_LOC_LIGHT_COLOR], lightColor, SHADER_UNIFORM_VEC3, key[0]);
+        SetShaderValue(shader, locs[VARIANT_LOC_VIEW_POS], &camera.position, SHADER_UNIFORM_VEC3);
+        model.materials[0].shader = shader;
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+            ClearBackground(DARKGRAY);
+
+            BeginMode3D(camera);
+                DrawModel(model, (Vector3){ 0, 0, 0 }, 1.0f, WHITE);
+                for (int i = 0; i < key[0]; i++) DrawSphere(lightPos[i], 0.1f, ColorFromNormalized((Vector4){ lightColor[i].x, lightColor[i].y, lightColor[i].z, 1.0f }));
+            EndMode3D();
+
+            DrawText(TextFormat("NR_LIGHTS %i  OCTAVES %i  SPECULAR %i   (1-4, O, S)", key[0], key[1], key[2]), 20, 40, 20, WHITE);
+            DrawText(TextFormat("%i variants compiled, %i cache hits, last compile %.2f ms", variants->compiles, variants->hits, variants->lastCompileMs), 20, 70, 20, WHITE);
+            DrawFPS(20, 10);
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    model.materials[0].shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };    // variants are unloaded with the set
+    UnloadModel(model);
+    UnloadShaderVariantSet(variants);
+
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+
+    return 0;
+}
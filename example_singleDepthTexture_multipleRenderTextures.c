@@ -1,7 +1,16 @@
 /*******************************************************************************************
 *
 * Example of using a single depth texture for multiple RenderTextures
-* 
+*
+* With the depth prepass on (press P), the depth of every object is rendered once into the
+* shared depth buffer, then each colour render texture is drawn with depth writes off and
+* GL_EQUAL depth testing, so each visible pixel runs the fragment shader exactly once across
+* all render textures. The overdraw counter shows samples shaded per pixel, measured with
+* an occlusion query (samples passing the depth test) around the colour passes, read one
+* frame late so it never stalls the CPU.
+*
+* NOTE: the prepass changes what render texture 1 shows: the sphere's depth is already in the
+* shared buffer, so the cylinder is only drawn where it is not hidden behind the sphere.
 *
 ********************************************************************************************/
 #include <stdlib.h>
@@ -10,46 +19,7 @@
 #include "rlgl.h"
 #include "external/glad.h"
 
-unsigned int depth_tex_id;
-
-RenderTexture2D MyLoadRenderTexture(int width, int height)
-{
-    RenderTexture2D target = { 0 };
-
-    target.id = rlLoadFramebuffer(); // Load an empty framebuffer
-
-    if (target.id > 0)
-    {
-        rlEnableFramebuffer(target.id);
-
-        // Create color texture (default to RGBA)
-        target.texture.id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
-        target.texture.width = width;
-        target.texture.height = height;
-        target.texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
-        target.texture.mipmaps = 1;
-
-        // Create depth renderbuffer/texture
-        target.depth.id = depth_tex_id;
-        target.depth.width = width;
-        target.depth.height = height;
-        target.depth.format = 19;       //DEPTH_COMPONENT_24BIT?
-        target.depth.mipmaps = 1;
-
-        // Attach color texture and depth renderbuffer/texture to FBO
-        rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
-
-        rlFramebufferAttach(target.id, depth_tex_id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
-
-        // Check if fbo is complete with attachments (valid)
-        if (rlFramebufferComplete(target.id)) TRACELOG(LOG_INFO, "FBO: [ID %i] Framebuffer object created successfully", target.id);
-
-        rlDisableFramebuffer();
-    }
-    else TRACELOG(LOG_WARNING, "FBO: Framebuffer object can not be created");
-
-    return target;
-}
+#include "function_RenderTextureDepth.c"          // Required for: LoadRenderTextureSharedDepth()
 
 //------------------------------------------------------------------------------------
 // Program main entry point
@@ -63,10 +33,11 @@ int main(void)
 
     InitWindow(screenWidth, screenHeight, "raylib example");
 
-    depth_tex_id=rlLoadTextureDepth(screenWidth,screenHeight,true);
+    // one depth renderbuffer attached to both render textures
+    unsigned int depth_tex_id=LoadDepthRenderbuffer(screenWidth,screenHeight,RT_DEPTH_24);
 
-    RenderTexture2D rendetex=MyLoadRenderTexture(screenWidth,screenHeight);
-    RenderTexture2D rendetex2=MyLoadRenderTexture(screenWidth,screenHeight);
+    RenderTexture2D rendetex=LoadRenderTextureSharedDepth(screenWidth,screenHeight,PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,depth_tex_id,RT_DEPTH_24);
+    RenderTexture2D rendetex2=LoadRenderTextureSharedDepth(screenWidth,screenHeight,PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,depth_tex_id,RT_DEPTH_24);
 
     Camera3D camera;
     camera.fovy=90;
@@ -77,15 +48,50 @@ int main(void)
 
     float phase=0;
 
+    // occlusion queries used to count the fragments shaded in the colour passes,
+    // double buffered: each frame reads the result of the previous frame's query so the
+    // CPU never waits for the GPU to finish
+    unsigned int query[2], numSamplesShaded=0;
+    glGenQueries(2, query);
+    int frame=0;
+
+    bool depth_prepass=true;
+
     SetTargetFPS(10);
     while (!WindowShouldClose())
         {
         phase+=GetFrameTime();
+        if (IsKeyPressed(KEY_P)) depth_prepass=!depth_prepass;
+
+        Vector3 sphere_pos=(Vector3){sin(phase)*1.6,0,-5};
 
         BeginDrawing();
         ClearBackground(BLACK);    
+
+        if (depth_prepass)
+        {
+            // Z-prepass: lay down the depth of ALL the objects once, without touching colour
+            BeginTextureMode(rendetex);
+            rlClearScreenBuffers();
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            BeginMode3D(camera);
+            DrawCylinder((Vector3){0,0,3},3,2,5,12,WHITE);
+            DrawSphere(sphere_pos,8,GREEN);
+            EndMode3D();
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            EndTextureMode();
+
+            // colour passes only shade the fragments that ended up visible,
+            // depth is read-only from here on
+            rlDisableDepthMask();
+            glDepthFunc(GL_EQUAL);
+        }
+
+        glBeginQuery(GL_SAMPLES_PASSED, query[frame%2]);
+
         BeginTextureMode(rendetex);
-        ClearBackground(BLACK);    
+        if (depth_prepass) glClear(GL_COLOR_BUFFER_BIT);
+        else ClearBackground(BLACK);    
         BeginMode3D(camera);
         DrawCylinder((Vector3){0,0,3},3,2,5,12,WHITE);
         EndMode3D();
@@ -94,10 +100,27 @@ int main(void)
         BeginTextureMode(rendetex2);
         glClear(GL_COLOR_BUFFER_BIT);
         BeginMode3D(camera);
-        DrawSphere((Vector3){sin(phase)*1.6,0,-5},8,GREEN);
+        DrawSphere(sphere_pos,8,GREEN);
         EndMode3D();
         EndTextureMode();
 
+        glEndQuery(GL_SAMPLES_PASSED);
+
+        // last frame's query, only read once the GPU made the result available
+        if (frame > 0)
+        {
+            unsigned int available=0;
+            glGetQueryObjectuiv(query[(frame + 1)%2], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) glGetQueryObjectuiv(query[(frame + 1)%2], GL_QUERY_RESULT, &numSamplesShaded);
+        }
+        frame++;
+
+        if (depth_prepass)
+        {
+            glDepthFunc(GL_LEQUAL);     // raylib's default
+            rlEnableDepthMask();
+        }
+
         if (IsKeyDown(KEY_ONE))
         {
         DrawTexturePro(rendetex.texture,
@@ -120,12 +143,19 @@ int main(void)
 
         DrawText("Hold pressed key 1 to show render texture 1",0,0,20,WHITE);
         DrawText("Hold pressed key 2 to show render texture 2",0,20,20,WHITE);
+        DrawText(TextFormat("Press P to toggle depth prepass: %s", depth_prepass? "ON" : "OFF"),0,40,20,WHITE);
+        DrawText(TextFormat("Overdraw (samples shaded per pixel): %.2f",
+            (float)numSamplesShaded/(float)(screenWidth*screenHeight)),0,60,20,WHITE);
 
         EndDrawing();    
         }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    glDeleteQueries(2, query);
+    UnloadRenderTextureDepth(rendetex, false);
+    UnloadRenderTextureDepth(rendetex2, false);
+    glDeleteRenderbuffers(1, &depth_tex_id);
     CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     return 0;
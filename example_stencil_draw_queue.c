@@ -0,0 +1,444 @@
+/*******************************************************************************************
+*
+* STENCIL draw queue example (using RenderTexture) for raylib
+*
+* example_stencil_renderTexture.c needs 3 rlDrawRenderBatchActive() flushes and a full
+* stencil clear for every masked region. With hundreds of clipped widgets per frame that
+* is hundreds of flushes.
+*
+* Here 2D primitives are queued instead of drawn, every primitive tagged with the stencil
+* state it needs (no stencil / write mask with ref N / test equal to ref N). On flush:
+*   1) every clip gets a stencil reference value. Clips that can not bleed into each other
+*      (their masks and contents don't overlap) share the same value, so a list of sibling
+*      widgets usually ends up using a single one.
+*   2) primitives are merged into batches of equal stencil state. A primitive can move to an
+*      earlier batch only if it does not overlap anything drawn in between, so the result
+*      looks the same as drawing in submission order.
+*   3) batches are drawn with one flush per real stencil state change and one stencil
+*      clear per frame.
+*
+* Press SPACE to switch between the queue and the immediate BeginStencilMode() path.
+*
+********************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+#include "function_RenderTextureDepth.c"          // Required for: LoadRenderTextureDepth()
+#include "function_StencilMode.c"                 // Required for: BeginStencilMode(), BeginStencilMask(), ...
+
+#define MAX_QUEUE_ITEMS     4096
+#define MAX_QUEUE_CLIPS     1024
+#define MAX_QUEUE_TEXT      32
+
+//----------------------------------------------------------------------------------
+// Stencil-aware draw queue
+//----------------------------------------------------------------------------------
+typedef enum {
+    STENCIL_NONE = 0,
+    STENCIL_WRITE,                      // colour writes off, stencil = ref
+    STENCIL_TEST                        // draw where stencil == ref
+} StencilMode;
+
+typedef enum {
+    QUEUE_RECTANGLE = 0,
+    QUEUE_RECTANGLE_ROUNDED,
+    QUEUE_CIRCLE,
+    QUEUE_TEXTURE,
+    QUEUE_TEXT
+} QueueItemType;
+
+typedef struct QueueItem {
+    QueueItemType type;
+    Rectangle bounds;                   // screen space bounds, used for overlap tests
+    Color color;
+    float roundness;
+    int segments;
+    Texture2D texture;
+    Rectangle source;
+    int fontSize;
+    char text[MAX_QUEUE_TEXT];
+
+    StencilMode mode;
+    int clip;                           // clip index, -1 if not clipped
+    int batch;                          // assigned on flush
+    int order;                          // submission index
+} QueueItem;
+
+typedef struct QueueClip {
+    Rectangle maskBounds;
+    Rectangle contentBounds;
+    bool hasMask, hasContent;
+    int ref;                            // stencil reference value, assigned on flush
+} QueueClip;
+
+typedef struct QueueBatch {
+    StencilMode mode;
+    int ref;
+    Rectangle bounds;                   // union of the item bounds in the batch
+} QueueBatch;
+
+typedef struct DrawQueue {
+    QueueItem items[MAX_QUEUE_ITEMS];
+    int itemCount;
+    QueueClip clips[MAX_QUEUE_CLIPS];
+    int clipCount;
+    QueueBatch batches[MAX_QUEUE_ITEMS];
+    int batchCount;
+
+    int currentClip;
+    StencilMode currentMode;
+} DrawQueue;
+
+static Rectangle RectUnion(Rectangle a, Rectangle b)
+{
+    float x0 = fminf(a.x, b.x), y0 = fminf(a.y, b.y);
+    float x1 = fmaxf(a.x + a.width, b.x + b.width), y1 = fmaxf(a.y + a.height, b.y + b.height);
+    return (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static bool RectOverlap(Rectangle a, Rectangle b)
+{
+    return (a.x < b.x + b.width) && (b.x < a.x + a.width) && (a.y < b.y + b.height) && (b.y < a.y + a.height);
+}
+
+static Rectangle RectIntersect(Rectangle a, Rectangle b)
+{
+    float x0 = fmaxf(a.x, b.x), y0 = fmaxf(a.y, b.y);
+    float x1 = fminf(a.x + a.width, b.x + b.width), y1 = fminf(a.y + a.height, b.y + b.height);
+    return (Rectangle){ x0, y0, fmaxf(x1 - x0, 0), fmaxf(y1 - y0, 0) };
+}
+
+void BeginDrawQueue(DrawQueue *q)
+{
+    q->itemCount = 0;
+    q->clipCount = 0;
+    q->batchCount = 0;
+    q->currentClip = -1;
+    q->currentMode = STENCIL_NONE;
+}
+
+// Following primitives are mask shapes of a new clip
+void QueueBeginClip(DrawQueue *q)
+{
+    if (q->clipCount >= MAX_QUEUE_CLIPS) return;
+    q->clips[q->clipCount] = (QueueClip){ 0 };
+    q->currentClip = q->clipCount++;
+    q->currentMode = STENCIL_WRITE;
+}
+
+// Following primitives are drawn inside the mask of the current clip
+void QueueEndClipMask(DrawQueue *q)
+{
+    if (q->currentClip >= 0) q->currentMode = STENCIL_TEST;
+}
+
+// Following primitives are not clipped
+void QueueEndClip(DrawQueue *q)
+{
+    q->currentClip = -1;
+    q->currentMode = STENCIL_NONE;
+}
+
+static QueueItem *QueuePush(DrawQueue *q, QueueItemType type, Rectangle bounds, Color color)
+{
+    if (q->itemCount >= MAX_QUEUE_ITEMS) return NULL;
+
+    QueueItem *item = &q->items[q->itemCount];
+    item->type = type;
+    item->bounds = bounds;
+    item->color = color;
+    item->mode = q->currentMode;
+    item->clip = q->currentClip;
+    item->order = q->itemCount++;
+
+    if (item->clip >= 0)
+    {
+        QueueClip *clip = &q->clips[item->clip];
+        if (item->mode == STENCIL_WRITE)
+        {
+            clip->maskBounds = clip->hasMask? RectUnion(clip->maskBounds, bounds) : bounds;
+            clip->hasMask = true;
+        }
+        else
+        {
+            clip->contentBounds = clip->hasContent? RectUnion(clip->contentBounds, bounds) : bounds;
+            clip->hasContent = true;
+        }
+    }
+
+    return item;
+}
+
+void QueueRectangle(DrawQueue *q, Rectangle rec, Color color)
+{
+    QueuePush(q, QUEUE_RECTANGLE, rec, color);
+}
+
+void QueueRectangleRounded(DrawQueue *q, Rectangle rec, float roundness, int segments, Color color)
+{
+    QueueItem *item = QueuePush(q, QUEUE_RECTANGLE_ROUNDED, rec, color);
+    if (item) { item->roundness = roundness; item->segments = segments; }
+}
+
+void QueueCircle(DrawQueue *q, Vector2 center, float radius, Color color)
+{
+    QueuePush(q, QUEUE_CIRCLE, (Rectangle){ center.x - radius, center.y - radius, 2*radius, 2*radius }, color);
+}
+
+void QueueTexture(DrawQueue *q, Texture2D texture, Rectangle source, Rectangle dest, Color tint)
+{
+    QueueItem *item = QueuePush(q, QUEUE_TEXTURE, dest, tint);
+    if (item) { item->texture = texture; item->source = source; }
+}
+
+void QueueText(DrawQueue *q, const char *text, int posX, int posY, int fontSize, Color color)
+{
+    QueueItem *item = QueuePush(q, QUEUE_TEXT, (Rectangle){ posX, posY, MeasureText(text, fontSize), fontSize }, color);
+    if (item)
+    {
+        if (strlen(text) >= MAX_QUEUE_TEXT) TRACELOG(LOG_WARNING, "QUEUE: Text \"%s\" truncated to %i characters, increase MAX_QUEUE_TEXT", text, MAX_QUEUE_TEXT - 1);
+        strncpy(item->text, text, MAX_QUEUE_TEXT - 1);
+        item->text[MAX_QUEUE_TEXT - 1] = '\0';
+        item->fontSize = fontSize;
+    }
+}
+
+// Clips A and B may share a stencil value only if neither can draw into the other's mask
+static bool ClipsConflict(const QueueClip *a, const QueueClip *b)
+{
+    Rectangle areaA = a->hasContent? RectUnion(a->maskBounds, a->contentBounds) : a->maskBounds;
+    Rectangle areaB = b->hasContent? RectUnion(b->maskBounds, b->contentBounds) : b->maskBounds;
+    return RectOverlap(areaA, b->maskBounds) || RectOverlap(areaB, a->maskBounds);
+}
+
+static void AssignClipRefs(DrawQueue *q)
+{
+    for (int c = 0; c < q->clipCount; c++)
+    {
+        bool used[256] = { 0 };
+        for (int p = 0; p < c; p++)
+            if (ClipsConflict(&q->clips[c], &q->clips[p])) used[q->clips[p].ref] = true;
+
+        int ref = 1;
+        while ((ref < 255) && used[ref]) ref++;
+        q->clips[c].ref = ref;      // NOTE: more than 254 mutually overlapping clips end up sharing 255
+    }
+}
+
+static int CompareQueueItems(const void *a, const void *b)
+{
+    const QueueItem *ia = (const QueueItem *)a;
+    const QueueItem *ib = (const QueueItem *)b;
+    if (ia->batch != ib->batch) return ia->batch - ib->batch;
+    return ia->order - ib->order;
+}
+
+static void BuildBatches(DrawQueue *q)
+{
+    q->batchCount = 0;
+
+    for (int i = 0; i < q->itemCount; i++)
+    {
+        QueueItem *item = &q->items[i];
+        int ref = (item->clip >= 0)? q->clips[item->clip].ref : 0;
+        int target = -1;
+
+        // Clipped content can only touch pixels inside its own mask (refs were assigned so
+        // that no other mask with the same ref is under it), so only that area matters
+        Rectangle bounds = item->bounds;
+        if (item->mode == STENCIL_TEST) bounds = RectIntersect(bounds, q->clips[item->clip].maskBounds);
+
+        // Walk back over the batches: join the first one with the same state,
+        // unless something in between overlaps this item
+        for (int b = q->batchCount - 1; b >= 0; b--)
+        {
+            if ((q->batches[b].mode == item->mode) && (q->batches[b].ref == ref)) { target = b; break; }
+            if (RectOverlap(q->batches[b].bounds, bounds)) break;
+        }
+
+        if (target == -1)
+        {
+            target = q->batchCount++;
+            q->batches[target] = (QueueBatch){ item->mode, ref, bounds };
+        }
+        else q->batches[target].bounds = RectUnion(q->batches[target].bounds, bounds);
+
+        item->batch = target;
+    }
+
+    qsort(q->items, q->itemCount, sizeof(QueueItem), CompareQueueItems);
+}
+
+static void SetQueueStencilState(StencilMode mode, int ref)
+{
+    switch (mode)
+    {
+        case STENCIL_NONE:
+            glDisable(GL_STENCIL_TEST);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            break;
+        case STENCIL_WRITE:
+            glEnable(GL_STENCIL_TEST);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glStencilFunc(GL_ALWAYS, ref, 0xFF);
+            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+            break;
+        case STENCIL_TEST:
+            glEnable(GL_STENCIL_TEST);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glStencilFunc(GL_EQUAL, ref, 0xFF);
+            glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+            break;
+        default: break;
+    }
+}
+
+static void DrawQueueItem(const QueueItem *item)
+{
+    switch (item->type)
+    {
+        case QUEUE_RECTANGLE: DrawRectangleRec(item->bounds, item->color); break;
+        case QUEUE_RECTANGLE_ROUNDED: DrawRectangleRounded(item->bounds, item->roundness, item->segments, item->color); break;
+        case QUEUE_CIRCLE: DrawCircleV((Vector2){ item->bounds.x + item->bounds.width/2, item->bounds.y + item->bounds.height/2 }, item->bounds.width/2, item->color); break;
+        case QUEUE_TEXTURE: DrawTexturePro(item->texture, item->source, item->bounds, (Vector2){ 0, 0 }, 0, item->color); break;
+        case QUEUE_TEXT: DrawText(item->text, (int)item->bounds.x, (int)item->bounds.y, item->fontSize, item->color); break;
+        default: break;
+    }
+}
+
+// Draw everything queued since BeginDrawQueue()
+// NOTE: target must have a stencil buffer
+void FlushDrawQueue(DrawQueue *q)
+{
+    if (q->itemCount == 0) return;
+
+    AssignClipRefs(q);
+    BuildBatches(q);
+
+    rlDrawRenderBatchActive();      // whatever was drawn before the queue
+    if (q->clipCount > 0) ClearStencilMask();
+
+    StencilMode mode = STENCIL_NONE;
+    int ref = 0;
+    for (int i = 0; i < q->itemCount; i++)
+    {
+        const QueueItem *item = &q->items[i];
+        const QueueBatch *batch = &q->batches[item->batch];
+
+        if ((batch->mode != mode) || (batch->ref != ref))
+        {
+            rlDrawRenderBatchActive();
+            stencilForcedFlushes++;
+            mode = batch->mode;
+            ref = batch->ref;
+            SetQueueStencilState(mode, ref);
+        }
+
+        DrawQueueItem(item);
+    }
+
+    rlDrawRenderBatchActive();
+    SetQueueStencilState(STENCIL_NONE, 0);
+
+    BeginDrawQueue(q);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    // -------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 600;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - stencil draw queue");
+
+    RenderTexture2D rendetex=LoadRenderTextureDepth(screenWidth,screenHeight,PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,RT_DEPTH_24_STENCIL_8);
+
+    Image noise=GenImagePerlinNoise(256,256,0,0,4);
+    Texture2D tex_noise=LoadTextureFromImage(noise);
+    UnloadImage(noise);
+
+    static DrawQueue queue;         // large, keep it off the stack
+    BeginDrawQueue(&queue);
+
+    bool use_queue=true;
+    float scroll=0;
+    int lastFlushes=0;
+
+    SetTargetFPS(60);
+    while (!WindowShouldClose())
+        {
+        if (IsKeyPressed(KEY_SPACE)) use_queue=!use_queue;
+        scroll+=GetFrameTime()*40;
+
+        stencilForcedFlushes=0;
+
+        BeginDrawing();
+        BeginTextureMode(rendetex);
+        ClearBackground(SKYBLUE);
+
+        // a grid of clipped "widgets": rounded frame, scrolling content clipped to it, label
+        for (int y=0;y<10;y++)
+            for (int x=0;x<12;x++)
+            {
+            Rectangle frame=(Rectangle){10+x*65,90+y*50,60,45};
+            Rectangle content=(Rectangle){frame.x-20,frame.y-20+fmodf(scroll+x*7+y*13,40),100,100};
+
+            if (use_queue)
+                {
+                QueueRectangle(&queue,(Rectangle){frame.x-2,frame.y-2,frame.width+4,frame.height+4},DARKGRAY);
+                QueueBeginClip(&queue);
+                    QueueRectangleRounded(&queue,frame,0.4,6,BLACK);
+                QueueEndClipMask(&queue);
+                    QueueTexture(&queue,tex_noise,(Rectangle){0,0,256,256},content,WHITE);
+                    QueueCircle(&queue,(Vector2){content.x+50,content.y+50},12,ORANGE);
+                QueueEndClip(&queue);
+                }
+            else
+                {
+                DrawRectangleRec((Rectangle){frame.x-2,frame.y-2,frame.width+4,frame.height+4},DARKGRAY);
+                ClearStencilMask();
+                BeginStencilMode();
+                    BeginStencilMask();
+                    DrawRectangleRounded(frame,0.4,6,BLACK);
+                    EndStencilMask();
+                DrawTexturePro(tex_noise,(Rectangle){0,0,256,256},content,(Vector2){0,0},0,WHITE);
+                DrawCircleV((Vector2){content.x+50,content.y+50},12,ORANGE);
+                EndStencilMode();
+                }
+            }
+
+        if (use_queue) FlushDrawQueue(&queue);
+
+        DrawText("Press SPACE to switch between draw queue and immediate stencil mode",10,10,20,BLACK);
+        DrawText(TextFormat("%s: %i stencil flushes last frame",use_queue? "QUEUE" : "IMMEDIATE",lastFlushes),10,40,20,BLACK);
+        DrawFPS(10,65);
+
+        EndTextureMode();
+
+        DrawTexturePro(rendetex.texture,
+        (Rectangle){0,0,screenWidth,-screenHeight},
+        (Rectangle){0,0,screenWidth,screenHeight},
+        (Vector2){0.0,0.0},
+        0,WHITE);
+
+        EndDrawing();
+
+        lastFlushes=stencilForcedFlushes;
+        }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadTexture(tex_noise);
+    UnloadRenderTextureDepth(rendetex, true);
+    CloseWindow();          // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -5,99 +5,103 @@
 * originally by Sandro kuridze (dnxa)
 * taken from https://github.com/raysan5/raylib/discussions/2964
 *
+* PushStencilClip()/PopStencilClip() add nestable masks: every push increments the stencil
+* value inside its mask (GL_INCR, only where the parent clip is) and every pop decrements
+* it back (GL_DECR), so content at nesting depth N is drawn where stencil == N.
+* After the last pop the buffer is back to all zeroes, it is only cleared once at the
+* start (or if a mask was left unbalanced) instead of once per mask.
+*
 ********************************************************************************************/
 #include <stdlib.h>
 #include "raylib.h"
 #include "rlgl.h"
 #include "external/glad.h"
 
-void BeginStencilMode()
-{
-	rlDrawRenderBatchActive();
-	glEnable(GL_STENCIL_TEST);
-}
-
-void ClearStencilMask()
-{
-	glClearStencil(0);
-	glClear( GL_STENCIL_BUFFER_BIT );
-}
+#include "function_RenderTextureDepth.c"          // Required for: LoadRenderTextureDepth()
+#include "function_StencilMode.c"                 // Required for: BeginStencilMode(), BeginStencilMask(), ...
 
-void BeginStencilMask()
-{
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-	glStencilFunc(GL_ALWAYS, 1, 0xFF);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-}
+#define MAX_STENCIL_CLIP_DEPTH     255      // 8-bit stencil buffer
 
-void EndStencilMask()
-{
-	rlDrawRenderBatchActive();	
-	glStencilFunc(GL_EQUAL, 1, 0xFF);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-}
+Rectangle stencilClipStack[MAX_STENCIL_CLIP_DEPTH];
+int stencilClipDepth = 0;
+int stencilClipOverflow = 0;            // pushes rejected on a full stack, their pops are ignored
+bool stencilNeedsClear = true;
 
-void EndStencilMode()
+// Start drawing the mask shapes of a (possibly nested) clip
+// NOTE: bounds must contain every mask shape, they are used to undo the mask on pop
+void PushStencilClip(Rectangle bounds)
 {
-	rlDrawRenderBatchActive();
-	glDisable(GL_STENCIL_TEST);
+	if (stencilClipDepth >= MAX_STENCIL_CLIP_DEPTH)
+	{
+		TRACELOG(LOG_WARNING, "STENCIL: Clip stack is full (%i levels)", MAX_STENCIL_CLIP_DEPTH);
+		stencilClipOverflow++;
+		return;
+	}
+
+	if (stencilClipDepth == 0)
+	{
+		BeginStencilMode();
+		if (stencilNeedsClear)
+		{
+			ClearStencilMask();
+			stencilNeedsClear = false;
+		}
+	}
+	else rlDrawRenderBatchActive();
+
+	stencilClipStack[stencilClipDepth] = bounds;
+
+	// same as BeginStencilMask() but only inside the parent clip, incrementing instead of replacing
+	BeginStencilMask();
+	glStencilFunc(GL_EQUAL, stencilClipDepth, 0xFF);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+
+	stencilClipDepth++;
 }
 
-// Load depth texture/renderbuffer (to be attached to fbo)
-// WARNING: OpenGL ES 2.0 requires GL_OES_depth_texture and WebGL requires WEBGL_depth_texture extensions
-unsigned int MyrlLoadTextureDepth(int width, int height, bool useRenderBuffer)
+// Mask shapes done, draw the clipped content
+void EndStencilClipMask()
 {
-    unsigned int id = 0;
-    glGenRenderbuffers(1, &id);
-    glBindRenderbuffer(GL_RENDERBUFFER, id);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-    glBindRenderbuffer(GL_RENDERBUFFER, 0);
-    TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Depth/Stencil renderbuffer loaded successfully", id);
-    return id;
+	EndStencilMask();
+	glStencilFunc(GL_EQUAL, stencilClipDepth, 0xFF);
 }
 
-
-RenderTexture2D MyLoadRenderTexture(int width, int height)
+// Undo the last pushed clip and go back to drawing inside its parent
+void PopStencilClip()
 {
-    RenderTexture2D target = { 0 };
+	if (stencilClipOverflow > 0)
+	{
+		stencilClipOverflow--;
+		return;
+	}
+	if (stencilClipDepth == 0) return;
 
-    target.id = rlLoadFramebuffer(); // Load an empty framebuffer
-
-    if (target.id > 0)
-    {
-        rlEnableFramebuffer(target.id);
-
-        // Create color texture (default to RGBA)
-        target.texture.id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
-        target.texture.width = width;
-        target.texture.height = height;
-        target.texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
-        target.texture.mipmaps = 1;
-
-        // Create depth renderbuffer/texture
-        target.depth.id = MyrlLoadTextureDepth(width, height, true);
-        target.depth.width = width;
-        target.depth.height = height;
-        target.depth.format = 19;       //DEPTH_COMPONENT_24BIT?
-        target.depth.mipmaps = 1;
-
-        // Attach color texture and depth renderbuffer/texture to FBO
-        rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+	rlDrawRenderBatchActive();
 
-        glBindFramebuffer(GL_FRAMEBUFFER, target.id);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depth.id );
+	// Decrement the pixels of this level back to the parent's value, its bounds cover them all
+	Rectangle bounds = stencilClipStack[stencilClipDepth - 1];
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glStencilFunc(GL_EQUAL, stencilClipDepth, 0xFF);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+	DrawRectangleRec(bounds, BLANK);
+	rlDrawRenderBatchActive();
 
-        // Check if fbo is complete with attachments (valid)
-        if (rlFramebufferComplete(target.id)) TRACELOG(LOG_INFO, "FBO: [ID %i] Framebuffer object created successfully", target.id);
+	stencilClipDepth--;
 
-        rlDisableFramebuffer();
-    }
-    else TRACELOG(LOG_WARNING, "FBO: Framebuffer object can not be created");
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-    return target;
+	if (stencilClipDepth == 0) EndStencilMode();
+	else glStencilFunc(GL_EQUAL, stencilClipDepth, 0xFF);
 }
 
+// Call when a frame could have left clips pushed (the stencil values are then unknown)
+void ResetStencilClips()
+{
+	stencilClipOverflow = 0;
+	while (stencilClipDepth > 0) PopStencilClip();
+	stencilNeedsClear = true;
+}
 
 //------------------------------------------------------------------------------------
 // Program main entry point
@@ -111,7 +115,7 @@ int main(void)
 
     InitWindow(800, 600, "raylib example");
 
-    RenderTexture2D rendetex=MyLoadRenderTexture(screenWidth,screenHeight);
+    RenderTexture2D rendetex=LoadRenderTextureDepth(screenWidth,screenHeight,PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,RT_DEPTH_24_STENCIL_8);
 
     Image noise=GenImagePerlinNoise(256,256,0,0,100);
     Texture2D tex_noise=LoadTextureFromImage(noise);
@@ -147,6 +151,36 @@ int main(void)
             (Vector2){200,200},0,WHITE);
 
         EndStencilMode();
+
+        // a stencil clear done by hand does not leave the clip stack's buffer at zero
+        stencilNeedsClear = true;
+        }
+
+        if (IsKeyDown(KEY_N))
+        {
+        // nested clips: tv screen > circular lens > small square, no stencil clears in between
+        PushStencilClip((Rectangle){110,110,260,180});
+            DrawRectangleRounded((Rectangle){110,110,260,180},0.5,10,BLACK);
+        EndStencilClipMask();
+            DrawTexturePro(tex_noise,
+                (Rectangle){0,0,256,256},(Rectangle){200+GetRandomValue(0,20),250,400,400},
+                (Vector2){200,200},0,WHITE);
+
+            PushStencilClip((Rectangle){180,140,120,120});
+                DrawCircle(240,200,60,BLACK);
+            EndStencilClipMask();
+                DrawRectangle(100,100,300,200,Fade(RED,0.6f));
+
+                PushStencilClip((Rectangle){215,175,50,50});
+                    DrawRectangle(215,175,50,50,BLACK);
+                EndStencilClipMask();
+                    DrawRectangle(100,100,300,200,YELLOW);
+                PopStencilClip();
+
+                // back in the lens: the square was decremented back, the ring also covers it
+                DrawCircleLines(240,200,40,WHITE);
+            PopStencilClip();
+        PopStencilClip();
         }
 
         /// Draw without the stencil mask
@@ -154,6 +188,8 @@ int main(void)
 
         DrawText("Hold SPACE key to draw using the stencil mask.",10,10,20,BLACK);
         DrawText("Hold SPACE key to draw using the stencil mask.",11,9,20,WHITE);
+        DrawText("Hold N key to draw using nested stencil clips.",10,35,20,BLACK);
+        DrawText("Hold N key to draw using nested stencil clips.",11,34,20,WHITE);
 
         EndTextureMode();
 
@@ -168,6 +204,7 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    UnloadRenderTextureDepth(rendetex, true);
     CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     return 0;
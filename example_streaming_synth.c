@@ -0,0 +1,295 @@
+/*******************************************************************************************
+*
+*   raylib example - streaming synthesiser with a lock-free event ring buffer
+*
+*   Instead of building a Wave up front, samples are generated on the audio thread in
+*   small blocks from an AudioStream callback. The game thread never touches the synth
+*   state: note and parameter changes are sent as events through a single producer,
+*   single consumer ring buffer that the callback drains before rendering each block.
+*   Nothing is allocated after initialization.
+*
+*   With a 256 frame stream buffer at 48 kHz a block is ~5.3 ms, so events are heard
+*   within a few milliseconds.
+*
+*   Keys: A S D F G H J K play notes, 1 2 3 waveform, UP/DOWN filter cutoff
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#define SYNTH_SAMPLE_RATE       48000
+#define SYNTH_BLOCK_FRAMES      256         // audio stream buffer size, sets the latency
+#define SYNTH_MAX_VOICES        8
+#define EVENT_RING_SIZE         256         // must be a power of 2
+
+typedef enum {
+    SYNTH_EVENT_NOTE_ON = 0,
+    SYNTH_EVENT_NOTE_OFF,
+    SYNTH_EVENT_WAVEFORM,
+    SYNTH_EVENT_CUTOFF,
+    SYNTH_EVENT_VOLUME
+} SynthEventType;
+
+typedef enum {
+    WAVEFORM_SINE = 0,
+    WAVEFORM_SAW,
+    WAVEFORM_SQUARE
+} SynthWaveform;
+
+typedef struct SynthEvent {
+    int type;
+    int note;                       // MIDI note for note events
+    float value;                    // velocity or parameter value
+} SynthEvent;
+
+// Single producer (game thread), single consumer (audio thread) ring buffer
+// NOTE: head is only written by the producer and tail only by the consumer
+typedef struct EventRing {
+    SynthEvent events[EVENT_RING_SIZE];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_uint dropped;            // events lost because the ring was full
+} EventRing;
+
+typedef struct SynthVoice {
+    bool active;
+    bool gate;                      // key held
+    int note;
+    float phase;                    // 0..1
+    float phaseStep;
+    float velocity;
+    float envelope;                 // linear attack/release
+} SynthVoice;
+
+typedef struct Synth {
+    SynthVoice voices[SYNTH_MAX_VOICES];
+    int waveform;
+    float cutoff;                   // one pole low pass, Hz
+    float volume;
+    float filterState;
+    float attackStep;               // envelope change per frame
+    float releaseStep;
+} Synth;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static EventRing eventRing = { 0 };
+static Synth synth = { 0 };         // only touched by the audio thread after init
+static atomic_int activeVoices = 0; // for display
+
+// Game thread: queue an event, returns false (and counts it) if the ring is full
+bool PushSynthEvent(EventRing *ring, SynthEvent event)
+{
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= EVENT_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    ring->events[head & (EVENT_RING_SIZE - 1)] = event;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);     // publish the event
+
+    return true;
+}
+
+// Audio thread: take the next event, returns false if there is none
+bool PopSynthEvent(EventRing *ring, SynthEvent *event)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (tail == head) return false;
+
+    *event = ring->events[tail & (EVENT_RING_SIZE - 1)];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);     // slot can be reused
+
+    return true;
+}
+
+static float NoteToFrequency(int note)
+{
+    return 440.0f*powf(2.0f, (note - 69)/12.0f);
+}
+
+static void ApplySynthEvent(Synth *s, SynthEvent event)
+{
+    switch (event.type)
+    {
+        case SYNTH_EVENT_NOTE_ON:
+        {
+            // free voice, or steal the quietest one
+            int slot = 0;
+            for (int i = 0; i < SYNTH_MAX_VOICES; i++)
+            {
+                if (!s->voices[i].active) { slot = i; break; }
+                if (s->voices[i].envelope < s->voices[slot].envelope) slot = i;
+            }
+
+            SynthVoice *v = &s->voices[slot];
+            v->active = true;
+            v->gate = true;
+            v->note = event.note;
+            v->phase = 0.0f;
+            v->phaseStep = NoteToFrequency(event.note)/SYNTH_SAMPLE_RATE;
+            v->velocity = event.value;
+            v->envelope = 0.0f;
+        } break;
+        case SYNTH_EVENT_NOTE_OFF:
+        {
+            for (int i = 0; i < SYNTH_MAX_VOICES; i++)
+            {
+                if (s->voices[i].active && (s->voices[i].note == event.note)) s->voices[i].gate = false;
+            }
+        } break;
+        case SYNTH_EVENT_WAVEFORM: s->waveform = (int)event.value; break;
+        case SYNTH_EVENT_CUTOFF: s->cutoff = event.value; break;
+        case SYNTH_EVENT_VOLUME: s->volume = event.value; break;
+        default: break;
+    }
+}
+
+static float Oscillator(int waveform, float phase)
+{
+    switch (waveform)
+    {
+        case WAVEFORM_SAW: return 2.0f*phase - 1.0f;
+        case WAVEFORM_SQUARE: return (phase < 0.5f)? 1.0f : -1.0f;
+        default: return sinf(2.0f*PI*phase);
+    }
+}
+
+// Audio thread: drain events, then render one block (mono, 32 bit float)
+void SynthAudioCallback(void *buffer, unsigned int frames)
+{
+    float *out = (float *)buffer;
+    SynthEvent event;
+
+    while (PopSynthEvent(&eventRing, &event)) ApplySynthEvent(&synth, event);
+
+    // one pole low pass coefficient, once per block
+    float alpha = 1.0f - expf(-2.0f*PI*synth.cutoff/SYNTH_SAMPLE_RATE);
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        float mix = 0.0f;
+
+        for (int v = 0; v < SYNTH_MAX_VOICES; v++)
+        {
+            SynthVoice *voice = &synth.voices[v];
+            if (!voice->active) continue;
+
+            if (voice->gate) voice->envelope = fminf(voice->envelope + synth.attackStep, 1.0f);
+            else
+            {
+                voice->envelope -= synth.releaseStep;
+                if (voice->envelope <= 0.0f) { voice->active = false; continue; }
+            }
+
+            mix += Oscillator(synth.waveform, voice->phase)*voice->envelope*voice->velocity;
+
+            voice->phase += voice->phaseStep;
+            if (voice->phase >= 1.0f) voice->phase -= 1.0f;
+        }
+
+        synth.filterState += alpha*(mix - synth.filterState);
+        out[i] = synth.filterState*synth.volume;
+    }
+
+    int count = 0;
+    for (int v = 0; v < SYNTH_MAX_VOICES; v++) count += synth.voices[v].active;
+    atomic_store_explicit(&activeVoices, count, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - streaming synthesiser");
+
+    InitAudioDevice();
+
+    synth.waveform = WAVEFORM_SAW;
+    synth.cutoff = 2000.0f;
+    synth.volume = 0.25f;
+    synth.attackStep = 1.0f/(0.005f*SYNTH_SAMPLE_RATE);     // 5 ms
+    synth.releaseStep = 1.0f/(0.250f*SYNTH_SAMPLE_RATE);    // 250 ms
+
+    // small buffer = low latency, must be set before the stream is created
+    SetAudioStreamBufferSizeDefault(SYNTH_BLOCK_FRAMES);
+    AudioStream stream = LoadAudioStream(SYNTH_SAMPLE_RATE, 32, 1);
+    SetAudioStreamCallback(stream, SynthAudioCallback);
+    PlayAudioStream(stream);
+
+    const int keys[8] = { KEY_A, KEY_S, KEY_D, KEY_F, KEY_G, KEY_H, KEY_J, KEY_K };
+    const int notes[8] = { 60, 62, 64, 65, 67, 69, 71, 72 };      // C major scale from middle C
+    const char *waveformNames[3] = { "sine", "saw", "square" };
+    int waveform = synth.waveform;
+    float cutoff = synth.cutoff;
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        for (int i = 0; i < 8; i++)
+        {
+            if (IsKeyPressed(keys[i])) PushSynthEvent(&eventRing, (SynthEvent){ SYNTH_EVENT_NOTE_ON, notes[i], 0.8f });
+            if (IsKeyReleased(keys[i])) PushSynthEvent(&eventRing, (SynthEvent){ SYNTH_EVENT_NOTE_OFF, notes[i], 0.0f });
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+            if (IsKeyPressed(KEY_ONE + i))
+            {
+                waveform = i;
+                PushSynthEvent(&eventRing, (SynthEvent){ SYNTH_EVENT_WAVEFORM, 0, (float)i });
+            }
+        }
+
+        if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_DOWN))
+        {
+            cutoff = Clamp(cutoff*(IsKeyDown(KEY_UP)? 1.03f : 0.97f), 50.0f, 18000.0f);
+            PushSynthEvent(&eventRing, (SynthEvent){ SYNTH_EVENT_CUTOFF, 0, cutoff });
+        }
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(BLACK);
+
+            for (int i = 0; i < 8; i++) DrawRectangle(100 + i*75, 200, 70, 150, IsKeyDown(keys[i])? ORANGE : LIGHTGRAY);
+            DrawText("A S D F G H J K: play   1 2 3: waveform   UP/DOWN: cutoff", 100, 100, 20, LIGHTGRAY);
+            DrawText(TextFormat("Waveform: %s   Cutoff: %.0f Hz   Active voices: %i", waveformNames[waveform], cutoff, atomic_load(&activeVoices)), 100, 130, 20, LIGHTGRAY);
+            DrawText(TextFormat("Block: %i frames (%.1f ms)   Dropped events: %u", SYNTH_BLOCK_FRAMES, SYNTH_BLOCK_FRAMES*1000.0f/SYNTH_SAMPLE_RATE, atomic_load(&eventRing.dropped)), 100, 160, 20, LIGHTGRAY);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadAudioStream(stream);
+    CloseAudioDevice();   // Close audio device
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -0,0 +1,287 @@
+/*******************************************************************************************
+*
+*   raylib example - memory-mapped texture cache with BC1/BC3 compression
+*
+*   LoadTexture() decodes the PNG on every run and GenTextureMipmaps() builds the mip chain
+*   on the GPU afterwards. function_TextureCache.c cooks the image once into a cache file
+*   holding the full mip chain (RGBA8, or BC1/BC3 compressed by a multithreaded encoder),
+*   later runs map that file and upload the levels straight from the mapping.
+*
+*   The example times, for each image:
+*     - LoadTexture() + GenTextureMipmaps()
+*     - cooking the RGBA8 and BC caches (first run cost)
+*     - loading each cache (every later run)
+*   and shows the VRAM of each texture plus the PSNR of the BC version against the source.
+*
+*   Usage: example_texture_cache [--cook] [image ...]      (default resources/parrots.png)
+*          --cook writes the caches of the given images without opening a window (offline cooker)
+*
+*   Keys: UP/DOWN zoom out/in to see the mip levels, R to cook and measure again
+*
+*   NOTE: BC textures need GL_EXT_texture_compression_s3tc (all desktop GPUs), on other GPUs
+*         LoadTextureCached() falls back to the RGBA8 cache
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "raylib.h"
+
+#include "function_TextureCache.c"
+
+#define TEXTURE_CACHE_DIR       "texture_cache"
+#define MAX_IMAGES              8
+
+typedef struct CacheBench {
+    const char *fileName;
+    Texture2D textures[3];          // LoadTexture() + GenTextureMipmaps(), RGBA8 cache, BC cache
+    double loadMs[3];
+    double cookMs[2];               // RGBA8, BC
+    float psnrBC;                   // level 0 of the BC cache against the source, dB
+} CacheBench;
+
+static const char *variantNames[3] = { "LoadTexture + GenTextureMipmaps", "RGBA8 cache", "BC cache" };
+
+// Decode one BC1 color block (plus BC3 alpha block when alphaBlock is not NULL) to 16 RGBA pixels
+static void DecodeBCBlock(const unsigned char *alphaBlock, const unsigned char *colorBlock, unsigned char *pixels)
+{
+    unsigned short c0 = colorBlock[0] | (colorBlock[1] << 8);
+    unsigned short c1 = colorBlock[2] | (colorBlock[3] << 8);
+    int palette[4][3];
+    UnpackColor565(c0, palette[0]);
+    UnpackColor565(c1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+        if ((c0 > c1) || (alphaBlock != NULL))
+        {
+            palette[2][c] = (2*palette[0][c] + palette[1][c] + 1)/3;
+            palette[3][c] = (palette[0][c] + 2*palette[1][c] + 1)/3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c])/2;
+            palette[3][c] = 0;
+        }
+    }
+
+    int alphas[8] = { 255, 255, 255, 255, 255, 255, 255, 255 };
+    unsigned long long alphaIndices = 0;
+    if (alphaBlock != NULL)
+    {
+        alphas[0] = alphaBlock[0];
+        alphas[1] = alphaBlock[1];
+        for (int p = 1; p < 7; p++) alphas[p + 1] = ((7 - p)*alphas[0] + p*alphas[1] + 3)/7;
+        for (int b = 0; b < 6; b++) alphaIndices |= (unsigned long long)alphaBlock[2 + b] << (b*8);
+    }
+
+    unsigned int indices = colorBlock[4] | (colorBlock[5] << 8) | (colorBlock[6] << 16) | ((unsigned int)colorBlock[7] << 24);
+    for (int i = 0; i < 16; i++)
+    {
+        int p = (indices >> (i*2)) & 3;
+        pixels[i*4] = (unsigned char)palette[p][0];
+        pixels[i*4 + 1] = (unsigned char)palette[p][1];
+        pixels[i*4 + 2] = (unsigned char)palette[p][2];
+        pixels[i*4 + 3] = (unsigned char)alphas[(alphaIndices >> (i*3)) & 7];
+    }
+}
+
+// PSNR over RGBA of the first level of a BC cache file against the source image
+static float GetCacheFilePSNR(const char *cacheFileName, const char *fileName)
+{
+    Image image = LoadImage(fileName);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    size_t size = 0;
+    unsigned char *data = MapCacheFile(cacheFileName, &size);
+    float psnr = 0.0f;
+
+    if ((data != NULL) && (image.data != NULL) && (size >= sizeof(TextureCacheHeader)))
+    {
+        TextureCacheHeader header;
+        memcpy(&header, data, sizeof(header));
+
+        if ((header.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) && (header.width == image.width) && (header.height == image.height))
+        {
+            int blockBytes = (header.format == PIXELFORMAT_COMPRESSED_DXT5_RGBA)? 16 : 8;
+            const unsigned char *blocks = data + sizeof(header);
+            const unsigned char *source = (const unsigned char *)image.data;
+            unsigned char pixels[16*4];
+            double error = 0.0;
+
+            for (int by = 0; by < header.height/4; by++)
+            {
+                for (int bx = 0; bx < header.width/4; bx++, blocks += blockBytes)
+                {
+                    if (blockBytes == 16) DecodeBCBlock(blocks, blocks + 8, pixels);
+                    else DecodeBCBlock(NULL, blocks, pixels);
+
+                    for (int i = 0; i < 16; i++)
+                    {
+                        const unsigned char *s = source + ((size_t)(by*4 + i/4)*header.width + bx*4 + i%4)*4;
+                        for (int c = 0; c < 4; c++) error += (double)(s[c] - pixels[i*4 + c])*(s[c] - pixels[i*4 + c]);
+                    }
+                }
+            }
+
+            double mse = error/((double)header.width*header.height*4.0);
+            psnr = (mse > 0.0)? (float)(10.0*log10(255.0*255.0/mse)) : 99.0f;
+        }
+    }
+
+    if (data != NULL) UnmapCacheFile(data, size);
+    UnloadImage(image);
+
+    return psnr;
+}
+
+// Load the three variants of every image, cooking both caches first
+static void RunTextureCacheBenchmark(CacheBench *bench, int count)
+{
+    bool s3tc = glfwExtensionSupported("GL_EXT_texture_compression_s3tc");
+
+    for (int n = 0; n < count; n++)
+    {
+        for (int v = 0; v < 3; v++) if (bench[n].textures[v].id != 0) UnloadTexture(bench[n].textures[v]);
+
+        // First run cost: decode, mip chain and encode
+        for (int f = 0; f < 2; f++)
+        {
+            char cacheFileName[1024];
+            strncpy(cacheFileName, GetTextureCacheFileName(bench[n].fileName, TEXTURE_CACHE_DIR, (TextureCacheFormat)f), sizeof(cacheFileName) - 1);
+            cacheFileName[sizeof(cacheFileName) - 1] = '\0';
+
+            double start = GetTime();
+            CookTextureCache(bench[n].fileName, cacheFileName, (TextureCacheFormat)f);
+            bench[n].cookMs[f] = (GetTime() - start)*1000.0;
+
+            if (f == TEXTURE_CACHE_BC) bench[n].psnrBC = GetCacheFilePSNR(cacheFileName, bench[n].fileName);
+        }
+
+        // Every later run: glFinish() so the GPU side of the upload (and mipmap generation) is counted
+        for (int v = 0; v < 3; v++)
+        {
+            double start = GetTime();
+            if (v == 0)
+            {
+                bench[n].textures[v] = LoadTexture(bench[n].fileName);
+                GenTextureMipmaps(&bench[n].textures[v]);
+            }
+            else bench[n].textures[v] = LoadTextureCached(bench[n].fileName, TEXTURE_CACHE_DIR, (v == 1)? TEXTURE_CACHE_RGBA8 : TEXTURE_CACHE_BC);
+            glFinish();
+            bench[n].loadMs[v] = (GetTime() - start)*1000.0;
+
+            SetTextureFilter(bench[n].textures[v], TEXTURE_FILTER_TRILINEAR);
+        }
+
+        printf("TEXCACHE: %s %ix%i\n", bench[n].fileName, bench[n].textures[0].width, bench[n].textures[0].height);
+        for (int v = 0; v < 3; v++)
+        {
+            printf("TEXCACHE:   %-32s load %7.2f ms | %2i levels | VRAM %8.1f KB (%.1fx smaller)\n", variantNames[v], bench[n].loadMs[v],
+                bench[n].textures[v].mipmaps, GetTextureVramSize(bench[n].textures[v])/1024.0f,
+                (float)GetTextureVramSize(bench[n].textures[0])/GetTextureVramSize(bench[n].textures[v]));
+        }
+        printf("TEXCACHE:   cook RGBA8 %.2f ms, BC %.2f ms, BC PSNR %.2f dB%s\n", bench[n].cookMs[0], bench[n].cookMs[1],
+            bench[n].psnrBC, s3tc? "" : " (no S3TC, BC cache not used)");
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    bool cookOnly = false;
+    CacheBench bench[MAX_IMAGES] = { 0 };
+    int imageCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--cook") == 0) cookOnly = true;
+        else if (imageCount < MAX_IMAGES) bench[imageCount++].fileName = argv[i];
+    }
+    if (imageCount == 0) bench[imageCount++].fileName = "resources/parrots.png";
+
+    if (cookOnly)
+    {
+        // Offline cooker: no window, no GL context needed
+        if (!DirectoryExists(TEXTURE_CACHE_DIR)) MakeDirectory(TEXTURE_CACHE_DIR);
+
+        int failed = 0;
+        for (int n = 0; n < imageCount; n++)
+        {
+            for (int f = 0; f < 2; f++)
+            {
+                const char *cacheFileName = GetTextureCacheFileName(bench[n].fileName, TEXTURE_CACHE_DIR, (TextureCacheFormat)f);
+                if (CookTextureCache(bench[n].fileName, cacheFileName, (TextureCacheFormat)f)) printf("TEXCACHE: cooked %s\n", cacheFileName);
+                else { printf("TEXCACHE: failed to cook %s\n", cacheFileName); failed++; }
+            }
+        }
+        return (failed > 0)? 1 : 0;
+    }
+
+    InitWindow(screenWidth, screenHeight, "raylib example - memory-mapped texture cache");
+
+    if (!DirectoryExists(TEXTURE_CACHE_DIR)) MakeDirectory(TEXTURE_CACHE_DIR);
+    RunTextureCacheBenchmark(bench, imageCount);
+
+    float scale = 0.5f;
+    int shown = 0;
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyDown(KEY_UP)) scale *= 0.98f;
+        if (IsKeyDown(KEY_DOWN)) scale *= 1.02f;
+        if (scale < 0.01f) scale = 0.01f;
+        if (scale > 1.0f) scale = 1.0f;
+        if (IsKeyPressed(KEY_SPACE)) shown = (shown + 1)%imageCount;
+        if (IsKeyPressed(KEY_R)) RunTextureCacheBenchmark(bench, imageCount);
+        //----------------------------------------------------------------------------------
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(DARKGRAY);
+
+            DrawText(TextFormat("%s, UP/DOWN zoom, SPACE next image, R cook again", GetFileName(bench[shown].fileName)), 20, 20, 20, LIGHTGRAY);
+
+            for (int v = 0; v < 3; v++)
+            {
+                Texture2D texture = bench[shown].textures[v];
+                int x = 20 + v*260;
+
+                DrawTextureEx(texture, (Vector2){ (float)x, 150.0f }, 0.0f, scale*240.0f/texture.width, WHITE);
+
+                DrawText(variantNames[v], x, 60, 10, LIGHTGRAY);
+                DrawText(TextFormat("load %.2f ms", bench[shown].loadMs[v]), x, 75, 20, (v == 0)? LIGHTGRAY : GREEN);
+                DrawText(TextFormat("VRAM %.0f KB, %i levels", GetTextureVramSize(texture)/1024.0f, texture.mipmaps), x, 100, 10, LIGHTGRAY);
+                if (v > 0) DrawText(TextFormat("first run cook %.2f ms", bench[shown].cookMs[v - 1]), x, 115, 10, GRAY);
+                if (v == 2) DrawText(TextFormat("PSNR %.2f dB", bench[shown].psnrBC), x, 130, 10, GRAY);
+            }
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    for (int n = 0; n < imageCount; n++)
+    {
+        for (int v = 0; v < 3; v++) UnloadTexture(bench[n].textures[v]);
+    }
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
@@ -11,6 +11,8 @@
 
 #include "external/glad.h"
 
+#include "function_TextureCache.c"
+
 
 //------------------------------------------------------------------------------------
 // Program main entry point
@@ -25,8 +27,8 @@ int main(void)
     InitWindow(screenWidth, screenHeight, "raylib example - lock MIPMAP level of a texture");
 
     Texture2D parrots;
-    parrots=LoadTexture("resources/parrots.png");           //SetTextureFilter(wabbit,TEXTURE_FILTER_ANISOTROPIC_8X);
-    GenTextureMipmaps(&parrots);
+    // mip chain cooked once into texture_cache/ (BC1 compressed when supported), later runs map the file
+    parrots=LoadTextureCached("resources/parrots.png", "texture_cache", TEXTURE_CACHE_BC);
     glEnable(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D,parrots.id);
     int mipmap_level=4;
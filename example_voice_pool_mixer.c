@@ -0,0 +1,384 @@
+/*******************************************************************************************
+*
+*   raylib example - allocation-free voice pool and software mixer
+*
+*   Instead of one Sound (and one audio buffer) per generated sound, sounds are played as
+*   voices of a fixed-capacity pool and mixed in software into a single stereo AudioStream:
+*     - all voices are preallocated, playing a sound never allocates
+*     - when the pool is full the lowest priority voice is stolen (the quietest one on a tie),
+*       a new sound with lower priority than every playing voice is rejected
+*     - per voice gain, pan (constant power) and pitch (linear interpolation resampling)
+*     - each voice is rendered into a mono block and accumulated into the left and right
+*       mix buffers with a SIMD multiply-add
+*   The game thread talks to the mixer through a lock-free SPSC command ring, handles
+*   let it change or stop a voice it started.
+*
+*   Keys: UP/DOWN spawn rate, SPACE burst of 100 sounds
+*
+********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include "raylib.h"
+
+#include "function_GenerateSoundWave.c"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#define MIXER_SAMPLE_RATE       48000
+#define MIXER_BLOCK_FRAMES      512
+#define MAX_VOICES              256
+#define MAX_SOURCES             16
+#define COMMAND_RING_SIZE       1024        // must be a power of 2
+
+typedef struct SoundSource {
+    float *samples;                 // mono float, loaded before gameplay
+    int frameCount;
+    int sampleRate;
+} SoundSource;
+
+typedef struct Voice {
+    bool active;
+    unsigned int handle;
+    int source;
+    float position;                 // in source frames
+    float step;                     // source frames per output frame (pitch)
+    float gain;
+    float pan;                      // -1 left .. 1 right
+    int priority;
+} Voice;
+
+typedef enum {
+    MIXER_CMD_PLAY = 0,
+    MIXER_CMD_STOP,
+    MIXER_CMD_SET
+} MixerCommandType;
+
+typedef struct MixerCommand {
+    int type;
+    unsigned int handle;
+    int source;
+    float gain;
+    float pan;
+    float pitch;
+    int priority;
+} MixerCommand;
+
+typedef struct Mixer {
+    SoundSource sources[MAX_SOURCES];
+    int sourceCount;
+    Voice voices[MAX_VOICES];
+
+    MixerCommand commands[COMMAND_RING_SIZE];   // game thread -> audio thread
+    atomic_uint commandHead;
+    atomic_uint commandTail;
+    unsigned int nextHandle;                    // game thread only
+
+    float mixLeft[MIXER_BLOCK_FRAMES];          // audio thread scratch
+    float mixRight[MIXER_BLOCK_FRAMES];
+    float voiceBlock[MIXER_BLOCK_FRAMES];
+
+    atomic_int activeVoices;                    // statistics, written by the audio thread
+    atomic_int stolen;
+    atomic_int rejected;
+    atomic_int droppedCommands;
+    atomic_int mixMicroseconds;
+} Mixer;
+
+static Mixer mixer = { 0 };
+
+//----------------------------------------------------------------------------------
+// SIMD accumulate: dst += src*gain
+//----------------------------------------------------------------------------------
+static void MixAccumulate(float *dst, const float *src, float gain, int count)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    __m256 g = _mm256_set1_ps(gain);
+    for (; i + 8 <= count; i += 8) _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+#elif defined(__SSE2__)
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+#endif
+    for (; i < count; i++) dst[i] += src[i]*gain;
+}
+
+//----------------------------------------------------------------------------------
+// Game thread API
+//----------------------------------------------------------------------------------
+// Register a sound, the mixer takes ownership of the wave samples (32 bit float, mono)
+// NOTE: call before the stream starts playing
+int AddMixerSource(Mixer *m, Wave wave)
+{
+    if ((m->sourceCount >= MAX_SOURCES) || (wave.sampleSize != 32) || (wave.channels != 1)) return -1;
+
+    m->sources[m->sourceCount] = (SoundSource){ (float *)wave.data, (int)wave.frameCount, (int)wave.sampleRate };
+    return m->sourceCount++;
+}
+
+static bool PushMixerCommand(Mixer *m, MixerCommand command)
+{
+    unsigned int head = atomic_load_explicit(&m->commandHead, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&m->commandTail, memory_order_acquire);
+
+    if (head - tail >= COMMAND_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&m->droppedCommands, 1, memory_order_relaxed);
+        return false;
+    }
+
+    m->commands[head & (COMMAND_RING_SIZE - 1)] = command;
+    atomic_store_explicit(&m->commandHead, head + 1, memory_order_release);
+    return true;
+}
+
+// Start a sound, returns a handle for StopVoice()/SetVoice() (0 if the command ring is full)
+unsigned int PlayVoice(Mixer *m, int source, float gain, float pan, float pitch, int priority)
+{
+    unsigned int handle = ++m->nextHandle;
+    if (handle == 0) handle = ++m->nextHandle;      // 0 is never a valid handle
+
+    if (!PushMixerCommand(m, (MixerCommand){ MIXER_CMD_PLAY, handle, source, gain, pan, pitch, priority })) return 0;
+    return handle;
+}
+
+void StopVoice(Mixer *m, unsigned int handle)
+{
+    PushMixerCommand(m, (MixerCommand){ MIXER_CMD_STOP, handle, 0, 0, 0, 0, 0 });
+}
+
+void SetVoice(Mixer *m, unsigned int handle, float gain, float pan, float pitch)
+{
+    PushMixerCommand(m, (MixerCommand){ MIXER_CMD_SET, handle, 0, gain, pan, pitch, 0 });
+}
+
+//----------------------------------------------------------------------------------
+// Audio thread
+//----------------------------------------------------------------------------------
+static Voice *FindVoice(Mixer *m, unsigned int handle)
+{
+    for (int i = 0; i < MAX_VOICES; i++) if (m->voices[i].active && (m->voices[i].handle == handle)) return &m->voices[i];
+    return NULL;
+}
+
+// Free voice, or the voice to steal: lowest priority, quietest on a tie
+static Voice *AllocateVoice(Mixer *m, int priority)
+{
+    Voice *victim = NULL;
+
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice *v = &m->voices[i];
+        if (!v->active) return v;
+        if ((victim == NULL) || (v->priority < victim->priority) || ((v->priority == victim->priority) && (v->gain < victim->gain))) victim = v;
+    }
+
+    if (victim->priority > priority)
+    {
+        atomic_fetch_add_explicit(&m->rejected, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    atomic_fetch_add_explicit(&m->stolen, 1, memory_order_relaxed);
+    return victim;
+}
+
+static void ApplyMixerCommand(Mixer *m, MixerCommand *c)
+{
+    switch (c->type)
+    {
+        case MIXER_CMD_PLAY:
+        {
+            if ((c->source < 0) || (c->source >= m->sourceCount)) break;
+
+            Voice *v = AllocateVoice(m, c->priority);
+            if (v == NULL) break;
+
+            const SoundSource *s = &m->sources[c->source];
+            *v = (Voice){ true, c->handle, c->source, 0.0f, c->pitch*s->sampleRate/MIXER_SAMPLE_RATE, c->gain, c->pan, c->priority };
+        } break;
+        case MIXER_CMD_STOP:
+        {
+            Voice *v = FindVoice(m, c->handle);
+            if (v != NULL) v->active = false;
+        } break;
+        case MIXER_CMD_SET:
+        {
+            Voice *v = FindVoice(m, c->handle);
+            if (v == NULL) break;
+
+            v->gain = c->gain;
+            v->pan = c->pan;
+            v->step = c->pitch*m->sources[v->source].sampleRate/MIXER_SAMPLE_RATE;
+        } break;
+        default: break;
+    }
+}
+
+// Resample a voice into dst, returns frames written (less than count when the sound ends)
+static int RenderVoice(Mixer *m, Voice *v, float *dst, int count)
+{
+    const SoundSource *s = &m->sources[v->source];
+    float position = v->position;
+    int last = s->frameCount - 1;
+    int i = 0;
+
+    for (; i < count; i++)
+    {
+        int index = (int)position;
+        if (index >= last) break;
+
+        float frac = position - index;
+        dst[i] = s->samples[index] + (s->samples[index + 1] - s->samples[index])*frac;
+        position += v->step;
+    }
+
+    v->position = position;
+    return i;
+}
+
+static double MixerNowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// Mix every active voice into the stereo stream buffer (interleaved float)
+void MixerAudioCallback(void *buffer, unsigned int frames)
+{
+    Mixer *m = &mixer;
+    float *out = (float *)buffer;
+    double start = MixerNowSeconds();
+
+    unsigned int head = atomic_load_explicit(&m->commandHead, memory_order_acquire);
+    unsigned int tail = atomic_load_explicit(&m->commandTail, memory_order_relaxed);
+    for (; tail != head; tail++) ApplyMixerCommand(m, &m->commands[tail & (COMMAND_RING_SIZE - 1)]);
+    atomic_store_explicit(&m->commandTail, tail, memory_order_release);
+
+    for (unsigned int done = 0; done < frames; done += MIXER_BLOCK_FRAMES)
+    {
+        int n = ((frames - done) < MIXER_BLOCK_FRAMES)? (int)(frames - done) : MIXER_BLOCK_FRAMES;
+
+        memset(m->mixLeft, 0, n*sizeof(float));
+        memset(m->mixRight, 0, n*sizeof(float));
+
+        for (int i = 0; i < MAX_VOICES; i++)
+        {
+            Voice *v = &m->voices[i];
+            if (!v->active) continue;
+
+            int rendered = RenderVoice(m, v, m->voiceBlock, n);
+
+            // constant power pan
+            float angle = (v->pan + 1.0f)*0.25f*PI;
+            MixAccumulate(m->mixLeft, m->voiceBlock, v->gain*cosf(angle), rendered);
+            MixAccumulate(m->mixRight, m->voiceBlock, v->gain*sinf(angle), rendered);
+
+            if (rendered < n) v->active = false;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            out[(done + i)*2 + 0] = fminf(fmaxf(m->mixLeft[i], -1.0f), 1.0f);
+            out[(done + i)*2 + 1] = fminf(fmaxf(m->mixRight[i], -1.0f), 1.0f);
+        }
+    }
+
+    int active = 0;
+    for (int i = 0; i < MAX_VOICES; i++) active += m->voices[i].active;
+    atomic_store_explicit(&m->activeVoices, active, memory_order_relaxed);
+    atomic_store_explicit(&m->mixMicroseconds, (int)((MixerNowSeconds() - start)*1e6), memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    const int screenWidth = 800;
+    const int screenHeight = 450;
+
+    InitWindow(screenWidth, screenHeight, "raylib example - voice pool and software mixer");
+
+    InitAudioDevice();
+
+    // all sounds are generated before gameplay, playing them allocates nothing
+    for (int i = 0; i < 8; i++)
+    {
+        Wave wave = GenerateSoundWave(MIXER_SAMPLE_RATE/4 + i*4000, MIXER_SAMPLE_RATE, 220.0f*powf(2.0f, i*3/12.0f), 1.0f);
+        if (AddMixerSource(&mixer, wave) < 0) UnloadWave(wave);
+    }
+
+    SetAudioStreamBufferSizeDefault(MIXER_BLOCK_FRAMES);
+    AudioStream stream = LoadAudioStream(MIXER_SAMPLE_RATE, 32, 2);
+    SetAudioStreamCallback(stream, MixerAudioCallback);
+    PlayAudioStream(stream);
+
+    float spawnRate = 200.0f;       // sounds per second
+    float spawnAccumulator = 0.0f;
+    unsigned int lastHandle = 0;
+
+    SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+    //--------------------------------------------------------------------------------------
+
+    // Main game loop
+    while (!WindowShouldClose())    // Detect window close button or ESC key
+    {
+        // Update
+        //----------------------------------------------------------------------------------
+        if (IsKeyDown(KEY_UP)) spawnRate = fminf(spawnRate*1.02f, 5000.0f);
+        if (IsKeyDown(KEY_DOWN)) spawnRate = fmaxf(spawnRate*0.98f, 1.0f);
+
+        int spawn = 0;
+        spawnAccumulator += spawnRate*GetFrameTime();
+        while (spawnAccumulator >= 1.0f) { spawnAccumulator -= 1.0f; spawn++; }
+        if (IsKeyPressed(KEY_SPACE)) spawn += 100;
+
+        for (int i = 0; i < spawn; i++)
+        {
+            lastHandle = PlayVoice(&mixer, GetRandomValue(0, mixer.sourceCount - 1), GetRandomValue(5, 30)/100.0f,
+                GetRandomValue(-100, 100)/100.0f, GetRandomValue(50, 200)/100.0f, GetRandomValue(0, 3));
+        }
+
+        // the last sound started follows the mouse
+        if (lastHandle != 0) SetVoice(&mixer, lastHandle, 0.3f, GetMouseX()*2.0f/screenWidth - 1.0f, 0.5f + GetMouseY()*1.5f/screenHeight);
+
+        // Draw
+        //----------------------------------------------------------------------------------
+        BeginDrawing();
+
+            ClearBackground(BLACK);
+
+            int active = atomic_load(&mixer.activeVoices);
+            DrawRectangle(20, 200, (int)(760.0f*active/MAX_VOICES), 30, ORANGE);
+            DrawRectangleLines(20, 200, 760, 30, LIGHTGRAY);
+
+            DrawText(TextFormat("Spawn rate: %.0f sounds/s (UP/DOWN), SPACE: burst of 100", spawnRate), 20, 40, 20, LIGHTGRAY);
+            DrawText(TextFormat("Active voices: %i / %i   stolen: %i   rejected: %i   dropped commands: %i", active, MAX_VOICES,
+                atomic_load(&mixer.stolen), atomic_load(&mixer.rejected), atomic_load(&mixer.droppedCommands)), 20, 70, 20, LIGHTGRAY);
+            DrawText(TextFormat("Mix time: %i us per callback, one AudioStream", atomic_load(&mixer.mixMicroseconds)), 20, 100, 20, LIGHTGRAY);
+
+        EndDrawing();
+        //----------------------------------------------------------------------------------
+    }
+
+    // De-Initialization
+    //--------------------------------------------------------------------------------------
+    UnloadAudioStream(stream);
+    for (int i = 0; i < mixer.sourceCount; i++) RL_FREE(mixer.sources[i].samples);
+    CloseAudioDevice();   // Close audio device
+    CloseWindow();        // Close window and OpenGL context
+    //--------------------------------------------------------------------------------------
+    return 0;
+}
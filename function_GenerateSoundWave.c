@@ -0,0 +1,45 @@
+/* Generates a decaying tone (sine wave with a linear volume ramp down to silence) into a new Wave.
+   This is the sound of example_generate_sound_at_runtime.c, shared with example_offline_sound_bake.c
+   so the offline renderer produces exactly what the runtime generator would.
+  NOTE:
+   1) Needs no audio device: the samples are only computed, the Wave can then be played with
+      LoadSoundFromWave() or written to disk with ExportWave().
+   2) Samples are 32 bit float, mono. Free the Wave with UnloadWave().
+   3) The phase is accumulated and wrapped to [0, 2*PI) so long sounds keep float precision.
+
+  Input arguments:  frameCount  = number of samples to generate
+                    sampleRate  = samples per second
+                    frequency   = tone frequency in Hz (sampleRate/(20*PI) gives the original sin(i/10))
+                    volume      = start volume, reaches 0 at the last sample
+
+  Return values: Wave with the generated samples, data is NULL if frameCount <= 0 or allocation failed
+*/
+Wave GenerateSoundWave(int frameCount, int sampleRate, float frequency, float volume)
+{
+  Wave wave = { 0 };
+
+  if (frameCount<=0) return wave;
+
+  float *samples=(float *)RL_MALLOC(frameCount*sizeof(float));
+  if (samples==NULL) return wave;
+
+  float phase=0.0f;
+  float phase_step=2.0f*PI*frequency/(float)sampleRate;
+  float volume_step=volume/(float)frameCount;
+
+  for (int i=0;i<frameCount;i++)
+    {
+    samples[i]=sinf(phase)*volume;
+    volume-=volume_step;
+    phase+=phase_step;
+    if (phase>=2.0f*PI) phase-=2.0f*PI;
+    }
+
+  wave.frameCount=frameCount;
+  wave.sampleRate=sampleRate;
+  wave.sampleSize=32;
+  wave.channels=1;
+  wave.data=samples;
+
+  return wave;
+}
@@ -0,0 +1,454 @@
+/* SIMD kernels for per-pixel CPU image work: channel swizzle, channel threshold, alpha from luma,
+   alpha premultiply and conversion of R8G8B8 / GRAY_ALPHA to R8G8B8A8.
+  NOTE:
+   1) The instruction set is chosen at compile time: AVX2 (-mavx2), SSSE3 (-mssse3), scalar otherwise.
+      x86-64 compilers only enable SSE2 by default, build with -mssse3, -mavx2 or -march=native to get
+      the byte shuffles. Every kernel has a *Scalar version giving exactly the same bytes.
+   2) The Image*() functions split images of IMAGE_KERNEL_PARALLEL_PIXELS or more into row blocks, one per
+      thread (see SetImageKernelThreads()). PLATFORM_WEB builds and IMAGE_KERNELS_SINGLE_THREAD run on the
+      calling thread only.
+   3) Except ImageFormatToRGBA8(), the Image*() functions expect PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 images
+      and leave other images untouched.
+   4) Kernels take a pixel count, Image*() functions work in place (the format conversion reallocates data).
+
+  Image functions:  ImageSwizzleChannels(image, r, g, b, a)     = output channel c takes input channel r/g/b/a (0..3)
+                    ImageThresholdChannel(image, src, dst, threshold, below, above)
+                                                                = channel dst becomes below if channel src < threshold,
+                                                                  above otherwise, -1 keeps the current value
+                    ImageAlphaFromLuma(image)                   = alpha becomes (38*r + 75*g + 15*b)/128
+                    ImagePremultiplyAlpha(image)                = rgb becomes rgb*a/255, rounded
+                    ImageFormatToRGBA8(image)                   = R8G8B8 or GRAY_ALPHA to R8G8B8A8, other formats through ImageFormat()
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define IMAGE_KERNELS_SIMD      "AVX2"
+#elif defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define IMAGE_KERNELS_SIMD      "SSSE3"
+#else
+    #define IMAGE_KERNELS_SIMD      "scalar"
+#endif
+
+#if defined(PLATFORM_WEB) && !defined(IMAGE_KERNELS_SINGLE_THREAD)
+    #define IMAGE_KERNELS_SINGLE_THREAD
+#endif
+#if !defined(IMAGE_KERNELS_SINGLE_THREAD)
+    #include <pthread.h>
+    #include <unistd.h>         // Required for: sysconf()
+#endif
+
+#define IMAGE_KERNEL_PARALLEL_PIXELS    (512*512)
+#define IMAGE_KERNEL_MAX_THREADS        32
+
+//----------------------------------------------------------------------------------
+// Scalar kernels (reference and tails)
+//----------------------------------------------------------------------------------
+void KernelSwizzleScalar(unsigned char *dst, const unsigned char *src, int count, const unsigned char order[4])
+{
+    for (int i = 0; i < count; i++, dst += 4, src += 4)
+    {
+        unsigned char p[4] = { src[0], src[1], src[2], src[3] };
+        dst[0] = p[order[0]]; dst[1] = p[order[1]]; dst[2] = p[order[2]]; dst[3] = p[order[3]];
+    }
+}
+
+void KernelThresholdScalar(unsigned char *pixels, int count, int srcChannel, int dstChannel, int threshold, int below, int above)
+{
+    for (int i = 0; i < count; i++, pixels += 4)
+    {
+        int value = (pixels[srcChannel] < threshold)? below : above;
+        if (value >= 0) pixels[dstChannel] = (unsigned char)value;
+    }
+}
+
+void KernelAlphaFromLumaScalar(unsigned char *pixels, int count)
+{
+    for (int i = 0; i < count; i++, pixels += 4) pixels[3] = (unsigned char)((38*pixels[0] + 75*pixels[1] + 15*pixels[2]) >> 7);
+}
+
+void KernelPremultiplyScalar(unsigned char *pixels, int count)
+{
+    for (int i = 0; i < count; i++, pixels += 4)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            unsigned int t = pixels[c]*pixels[3] + 128;
+            pixels[c] = (unsigned char)((t + (t >> 8)) >> 8);     // exact round(v*a/255)
+        }
+    }
+}
+
+void KernelRGBToRGBAScalar(unsigned char *dst, const unsigned char *src, int count)
+{
+    for (int i = 0; i < count; i++, dst += 4, src += 3) { dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255; }
+}
+
+void KernelGrayAlphaToRGBAScalar(unsigned char *dst, const unsigned char *src, int count)
+{
+    for (int i = 0; i < count; i++, dst += 4, src += 2) { dst[0] = dst[1] = dst[2] = src[0]; dst[3] = src[1]; }
+}
+
+//----------------------------------------------------------------------------------
+// SIMD kernels, 4 pixels per 128 bit register, 8 per 256 bit register
+//----------------------------------------------------------------------------------
+#if defined(__AVX2__)
+typedef __m256i vbyte;
+#define VB_BYTES                32
+#define VB_LOAD(p)              _mm256_loadu_si256((const __m256i *)(p))
+#define VB_STORE(p, v)          _mm256_storeu_si256((__m256i *)(p), v)
+#define VB_REPEAT16(p)          _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(p)))     // 16 byte pattern in both lanes
+#define VB_SET1_8(x)            _mm256_set1_epi8((char)(x))
+#define VB_SET1_32(x)           _mm256_set1_epi32((int)(x))
+#define VB_SET1_16(x)           _mm256_set1_epi16((short)(x))
+#define VB_SHUFFLE(a, m)        _mm256_shuffle_epi8(a, m)
+#define VB_AND(a, b)            _mm256_and_si256(a, b)
+#define VB_ANDNOT(a, b)         _mm256_andnot_si256(a, b)
+#define VB_OR(a, b)             _mm256_or_si256(a, b)
+#define VB_ZERO()               _mm256_setzero_si256()
+#define VB_MIN_U8(a, b)         _mm256_min_epu8(a, b)
+#define VB_CMPEQ_8(a, b)        _mm256_cmpeq_epi8(a, b)
+#define VB_MADDUBS(a, b)        _mm256_maddubs_epi16(a, b)
+#define VB_MADD16(a, b)         _mm256_madd_epi16(a, b)
+#define VB_SRLI32(a, n)         _mm256_srli_epi32(a, n)
+#define VB_SLLI32(a, n)         _mm256_slli_epi32(a, n)
+#define VB_SRLI16(a, n)         _mm256_srli_epi16(a, n)
+#define VB_ADD16(a, b)          _mm256_add_epi16(a, b)
+#define VB_MULLO16(a, b)        _mm256_mullo_epi16(a, b)
+#define VB_UNPACKLO8(a, b)      _mm256_unpacklo_epi8(a, b)
+#define VB_UNPACKHI8(a, b)      _mm256_unpackhi_epi8(a, b)
+#define VB_PACKUS16(a, b)       _mm256_packus_epi16(a, b)
+#define VB_SHUFFLELO16(a, i)    _mm256_shufflelo_epi16(a, i)
+#define VB_SHUFFLEHI16(a, i)    _mm256_shufflehi_epi16(a, i)
+#elif defined(__SSSE3__)
+typedef __m128i vbyte;
+#define VB_BYTES                16
+#define VB_LOAD(p)              _mm_loadu_si128((const __m128i *)(p))
+#define VB_STORE(p, v)          _mm_storeu_si128((__m128i *)(p), v)
+#define VB_REPEAT16(p)          _mm_loadu_si128((const __m128i *)(p))
+#define VB_SET1_8(x)            _mm_set1_epi8((char)(x))
+#define VB_SET1_32(x)           _mm_set1_epi32((int)(x))
+#define VB_SET1_16(x)           _mm_set1_epi16((short)(x))
+#define VB_SHUFFLE(a, m)        _mm_shuffle_epi8(a, m)
+#define VB_AND(a, b)            _mm_and_si128(a, b)
+#define VB_ANDNOT(a, b)         _mm_andnot_si128(a, b)
+#define VB_OR(a, b)             _mm_or_si128(a, b)
+#define VB_ZERO()               _mm_setzero_si128()
+#define VB_MIN_U8(a, b)         _mm_min_epu8(a, b)
+#define VB_CMPEQ_8(a, b)        _mm_cmpeq_epi8(a, b)
+#define VB_MADDUBS(a, b)        _mm_maddubs_epi16(a, b)
+#define VB_MADD16(a, b)         _mm_madd_epi16(a, b)
+#define VB_SRLI32(a, n)         _mm_srli_epi32(a, n)
+#define VB_SLLI32(a, n)         _mm_slli_epi32(a, n)
+#define VB_SRLI16(a, n)         _mm_srli_epi16(a, n)
+#define VB_ADD16(a, b)          _mm_add_epi16(a, b)
+#define VB_MULLO16(a, b)        _mm_mullo_epi16(a, b)
+#define VB_UNPACKLO8(a, b)      _mm_unpacklo_epi8(a, b)
+#define VB_UNPACKHI8(a, b)      _mm_unpackhi_epi8(a, b)
+#define VB_PACKUS16(a, b)       _mm_packus_epi16(a, b)
+#define VB_SHUFFLELO16(a, i)    _mm_shufflelo_epi16(a, i)
+#define VB_SHUFFLEHI16(a, i)    _mm_shufflehi_epi16(a, i)
+#endif
+
+#if defined(VB_BYTES)
+#define VB_PIXELS   (VB_BYTES/4)
+
+void KernelSwizzle(unsigned char *dst, const unsigned char *src, int count, const unsigned char order[4])
+{
+    unsigned char pattern[16];
+    for (int i = 0; i < 16; i++) pattern[i] = (unsigned char)((i & ~3) + order[i & 3]);
+    vbyte mask = VB_REPEAT16(pattern);
+
+    int i = 0;
+    for (; i + VB_PIXELS <= count; i += VB_PIXELS) VB_STORE(dst + i*4, VB_SHUFFLE(VB_LOAD(src + i*4), mask));
+    KernelSwizzleScalar(dst + i*4, src + i*4, count - i, order);
+}
+
+void KernelThreshold(unsigned char *pixels, int count, int srcChannel, int dstChannel, int threshold, int below, int above)
+{
+    // Outside [0, 256] every value is on the same side, clamp so threshold - 1 fits in a byte
+    if (threshold < 0) threshold = 0;
+    else if (threshold > 256) threshold = 256;
+
+    unsigned char broadcast[16], channel[16];
+    for (int i = 0; i < 16; i++)
+    {
+        broadcast[i] = (unsigned char)((i & ~3) + srcChannel);
+        channel[i] = ((i & 3) == dstChannel)? 0xff : 0;
+    }
+    vbyte broadcastMask = VB_REPEAT16(broadcast);
+    vbyte channelMask = VB_REPEAT16(channel);
+    vbyte limit = VB_SET1_8((threshold > 0)? threshold - 1 : 0);
+    vbyte belowValue = VB_SET1_8(below), aboveValue = VB_SET1_8(above);
+
+    int i = 0;
+    for (; i + VB_PIXELS <= count; i += VB_PIXELS)
+    {
+        vbyte x = VB_LOAD(pixels + i*4);
+        vbyte v = VB_SHUFFLE(x, broadcastMask);                                     // source channel in every byte of its pixel
+        vbyte lt = (threshold > 0)? VB_CMPEQ_8(VB_MIN_U8(v, limit), v) : VB_ZERO();   // v <= threshold - 1, unsigned
+        vbyte b = (below >= 0)? belowValue : x;
+        vbyte a = (above >= 0)? aboveValue : x;
+        vbyte value = VB_OR(VB_AND(lt, b), VB_ANDNOT(lt, a));
+        VB_STORE(pixels + i*4, VB_OR(VB_ANDNOT(channelMask, x), VB_AND(channelMask, value)));
+    }
+    KernelThresholdScalar(pixels + i*4, count - i, srcChannel, dstChannel, threshold, below, above);
+}
+
+void KernelAlphaFromLuma(unsigned char *pixels, int count)
+{
+    vbyte weights = VB_SET1_32(38 | (75 << 8) | (15 << 16));       // signed bytes for maddubs, alpha weight 0
+    vbyte ones = VB_SET1_16(1);
+    vbyte rgbMask = VB_SET1_32(0x00ffffff);
+
+    int i = 0;
+    for (; i + VB_PIXELS <= count; i += VB_PIXELS)
+    {
+        vbyte x = VB_LOAD(pixels + i*4);
+        vbyte luma = VB_MADD16(VB_MADDUBS(x, weights), ones);      // 38r + 75g + 15b per 32 bit pixel
+        VB_STORE(pixels + i*4, VB_OR(VB_AND(x, rgbMask), VB_SLLI32(VB_SRLI32(luma, 7), 24)));
+    }
+    KernelAlphaFromLumaScalar(pixels + i*4, count - i);
+}
+
+void KernelPremultiply(unsigned char *pixels, int count)
+{
+    vbyte zero = VB_ZERO();
+    // per 64 bit pixel of 16 bit lanes: keep rgb lanes of the broadcast alpha, alpha lane multiplies by 255
+    vbyte keepRgb = VB_UNPACKLO8(VB_SET1_32(0x00ffffff), VB_SET1_32(0x00ffffff));
+    vbyte alpha255 = VB_ANDNOT(keepRgb, VB_SET1_16(255));
+    vbyte round = VB_SET1_16(128);
+
+    int i = 0;
+    for (; i + VB_PIXELS <= count; i += VB_PIXELS)
+    {
+        vbyte x = VB_LOAD(pixels + i*4);
+        vbyte lo = VB_UNPACKLO8(x, zero);
+        vbyte hi = VB_UNPACKHI8(x, zero);
+
+        vbyte alo = VB_OR(VB_AND(VB_SHUFFLEHI16(VB_SHUFFLELO16(lo, 0xff), 0xff), keepRgb), alpha255);
+        vbyte ahi = VB_OR(VB_AND(VB_SHUFFLEHI16(VB_SHUFFLELO16(hi, 0xff), 0xff), keepRgb), alpha255);
+
+        vbyte tlo = VB_ADD16(VB_MULLO16(lo, alo), round);
+        vbyte thi = VB_ADD16(VB_MULLO16(hi, ahi), round);
+        tlo = VB_SRLI16(VB_ADD16(tlo, VB_SRLI16(tlo, 8)), 8);
+        thi = VB_SRLI16(VB_ADD16(thi, VB_SRLI16(thi, 8)), 8);
+
+        VB_STORE(pixels + i*4, VB_PACKUS16(tlo, thi));
+    }
+    KernelPremultiplyScalar(pixels + i*4, count - i);
+}
+
+void KernelRGBToRGBA(unsigned char *dst, const unsigned char *src, int count)
+{
+    static const unsigned char expand[16] = { 0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80 };
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256i mask = VB_REPEAT16(expand);
+    __m256i alpha = _mm256_set1_epi32((int)0xff000000);
+    for (; i + 10 <= count; i += 8)        // the second 16 byte load ends 28 bytes in
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(src + i*3));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + i*3 + 12));
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256((__m256i *)(dst + i*4), _mm256_or_si256(_mm256_shuffle_epi8(x, mask), alpha));
+    }
+#else
+    __m128i mask = _mm_loadu_si128((const __m128i *)expand);
+    __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    for (; i + 6 <= count; i += 4)         // 16 byte load for 12 bytes of pixels
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i*3));
+        _mm_storeu_si128((__m128i *)(dst + i*4), _mm_or_si128(_mm_shuffle_epi8(x, mask), alpha));
+    }
+#endif
+    KernelRGBToRGBAScalar(dst + i*4, src + i*3, count - i);
+}
+
+void KernelGrayAlphaToRGBA(unsigned char *dst, const unsigned char *src, int count)
+{
+    static const unsigned char expand[32] = { 0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7,
+                                              8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15 };
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256i mask = _mm256_loadu_si256((const __m256i *)expand);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i x = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(src + i*2)));
+        _mm256_storeu_si256((__m256i *)(dst + i*4), _mm256_shuffle_epi8(x, mask));
+    }
+#else
+    __m128i maskLo = _mm_loadu_si128((const __m128i *)expand);
+    __m128i maskHi = _mm_loadu_si128((const __m128i *)(expand + 16));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i*2));
+        _mm_storeu_si128((__m128i *)(dst + i*4), _mm_shuffle_epi8(x, maskLo));
+        _mm_storeu_si128((__m128i *)(dst + i*4 + 16), _mm_shuffle_epi8(x, maskHi));
+    }
+#endif
+    KernelGrayAlphaToRGBAScalar(dst + i*4, src + i*2, count - i);
+}
+#else
+void KernelSwizzle(unsigned char *dst, const unsigned char *src, int count, const unsigned char order[4]) { KernelSwizzleScalar(dst, src, count, order); }
+void KernelThreshold(unsigned char *pixels, int count, int srcChannel, int dstChannel, int threshold, int below, int above) { KernelThresholdScalar(pixels, count, srcChannel, dstChannel, threshold, below, above); }
+void KernelAlphaFromLuma(unsigned char *pixels, int count) { KernelAlphaFromLumaScalar(pixels, count); }
+void KernelPremultiply(unsigned char *pixels, int count) { KernelPremultiplyScalar(pixels, count); }
+void KernelRGBToRGBA(unsigned char *dst, const unsigned char *src, int count) { KernelRGBToRGBAScalar(dst, src, count); }
+void KernelGrayAlphaToRGBA(unsigned char *dst, const unsigned char *src, int count) { KernelGrayAlphaToRGBAScalar(dst, src, count); }
+#endif
+
+//----------------------------------------------------------------------------------
+// Row block threading
+//----------------------------------------------------------------------------------
+typedef struct PixelKernelArgs {
+    unsigned char *dst;
+    const unsigned char *src;
+    int srcBytesPerPixel;
+    unsigned char order[4];
+    int srcChannel, dstChannel, threshold, below, above;
+} PixelKernelArgs;
+
+typedef void (*PixelKernelFunc)(const PixelKernelArgs *args, int first, int count);
+
+static int imageKernelThreads = 0;      // 0: one per core
+
+// Threads used by the Image*() functions for large images, 0 uses every core
+void SetImageKernelThreads(int count)
+{
+    imageKernelThreads = (count > IMAGE_KERNEL_MAX_THREADS)? IMAGE_KERNEL_MAX_THREADS : count;
+}
+
+#if !defined(IMAGE_KERNELS_SINGLE_THREAD)
+typedef struct PixelKernelTask {
+    PixelKernelFunc func;
+    const PixelKernelArgs *args;
+    int first;
+    int count;
+    pthread_t thread;
+    bool started;                       // false: thread could not be created, the block ran inline
+} PixelKernelTask;
+
+static void *PixelKernelThread(void *arg)
+{
+    PixelKernelTask *task = (PixelKernelTask *)arg;
+    task->func(task->args, task->first, task->count);
+    return NULL;
+}
+#endif
+
+static void RunPixelKernel(PixelKernelFunc func, const PixelKernelArgs *args, int width, int height)
+{
+#if !defined(IMAGE_KERNELS_SINGLE_THREAD)
+    int threads = (imageKernelThreads > 0)? imageKernelThreads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > IMAGE_KERNEL_MAX_THREADS) threads = IMAGE_KERNEL_MAX_THREADS;
+    if (threads > height) threads = height;
+
+    if ((threads > 1) && (width*height >= IMAGE_KERNEL_PARALLEL_PIXELS))
+    {
+        PixelKernelTask tasks[IMAGE_KERNEL_MAX_THREADS];
+        int rowsPerTask = (height + threads - 1)/threads;
+
+        for (int t = 0; t < threads; t++)
+        {
+            int firstRow = t*rowsPerTask;
+            int rows = (firstRow + rowsPerTask > height)? height - firstRow : rowsPerTask;
+            tasks[t] = (PixelKernelTask){ .func = func, .args = args, .first = firstRow*width, .count = (rows > 0)? rows*width : 0 };
+            if (t > 0)
+            {
+                tasks[t].started = (pthread_create(&tasks[t].thread, NULL, PixelKernelThread, &tasks[t]) == 0);
+                if (!tasks[t].started) func(args, tasks[t].first, tasks[t].count);
+            }
+        }
+
+        func(args, tasks[0].first, tasks[0].count);       // first block on the calling thread
+        for (int t = 1; t < threads; t++) if (tasks[t].started) pthread_join(tasks[t].thread, NULL);
+        return;
+    }
+#endif
+    func(args, 0, width*height);
+}
+
+static void SwizzleTask(const PixelKernelArgs *a, int first, int count) { KernelSwizzle(a->dst + first*4, a->src + first*4, count, a->order); }
+static void ThresholdTask(const PixelKernelArgs *a, int first, int count) { KernelThreshold(a->dst + first*4, count, a->srcChannel, a->dstChannel, a->threshold, a->below, a->above); }
+static void AlphaFromLumaTask(const PixelKernelArgs *a, int first, int count) { KernelAlphaFromLuma(a->dst + first*4, count); }
+static void PremultiplyTask(const PixelKernelArgs *a, int first, int count) { KernelPremultiply(a->dst + first*4, count); }
+static void ConvertToRGBATask(const PixelKernelArgs *a, int first, int count)
+{
+    if (a->srcBytesPerPixel == 3) KernelRGBToRGBA(a->dst + first*4, a->src + first*3, count);
+    else KernelGrayAlphaToRGBA(a->dst + first*4, a->src + first*2, count);
+}
+
+static bool IsImageRGBA8(const Image *image, const char *function)
+{
+    if ((image->data != NULL) && (image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)) return true;
+
+    TRACELOG(LOG_WARNING, "IMAGE: %s() needs an R8G8B8A8 image", function);
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Image functions
+//----------------------------------------------------------------------------------
+void ImageSwizzleChannels(Image *image, int r, int g, int b, int a)
+{
+    if (!IsImageRGBA8(image, "ImageSwizzleChannels")) return;
+
+    PixelKernelArgs args = { .dst = (unsigned char *)image->data, .src = (const unsigned char *)image->data,
+        .order = { (unsigned char)(r & 3), (unsigned char)(g & 3), (unsigned char)(b & 3), (unsigned char)(a & 3) } };
+    RunPixelKernel(SwizzleTask, &args, image->width, image->height);
+}
+
+void ImageThresholdChannel(Image *image, int srcChannel, int dstChannel, int threshold, int below, int above)
+{
+    if (!IsImageRGBA8(image, "ImageThresholdChannel")) return;
+
+    PixelKernelArgs args = { .dst = (unsigned char *)image->data, .srcChannel = srcChannel & 3, .dstChannel = dstChannel & 3,
+        .threshold = threshold, .below = below, .above = above };
+    RunPixelKernel(ThresholdTask, &args, image->width, image->height);
+}
+
+void ImageAlphaFromLuma(Image *image)
+{
+    if (!IsImageRGBA8(image, "ImageAlphaFromLuma")) return;
+
+    PixelKernelArgs args = { .dst = (unsigned char *)image->data };
+    RunPixelKernel(AlphaFromLumaTask, &args, image->width, image->height);
+}
+
+void ImagePremultiplyAlpha(Image *image)
+{
+    if (!IsImageRGBA8(image, "ImagePremultiplyAlpha")) return;
+
+    PixelKernelArgs args = { .dst = (unsigned char *)image->data };
+    RunPixelKernel(PremultiplyTask, &args, image->width, image->height);
+}
+
+void ImageFormatToRGBA8(Image *image)
+{
+    if ((image->data == NULL) || (image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)) return;
+
+    if ((image->mipmaps > 1) || ((image->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8) && (image->format != PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA)))
+    {
+        ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        return;
+    }
+
+    unsigned char *pixels = (unsigned char *)RL_MALLOC((size_t)image->width*image->height*4);
+    PixelKernelArgs args = { .dst = pixels, .src = (const unsigned char *)image->data,
+        .srcBytesPerPixel = (image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8)? 3 : 2 };
+    RunPixelKernel(ConvertToRGBATask, &args, image->width, image->height);
+
+    RL_FREE(image->data);
+    image->data = pixels;
+    image->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+}
+
+// example usage
+// ImageFormatToRGBA8(&image);
+// ImageSwizzleChannels(&image, 2, 1, 0, 3);       // BGRA <-> RGBA
+// ImageThresholdChannel(&image, 3, 3, 243, 0, -1); // alpha below 95% cleared, rest kept
@@ -0,0 +1,214 @@
+/* Deterministic input record/replay for fixed-timestep loops.
+   The simulation reads input through the Trace*() queries below instead of IsKeyDown(), GetMousePosition(), ...
+   Depending on the mode the input comes from raylib (live), from raylib and is written to a file (record),
+   or is read back from a file (replay), so a benchmark can run on the identical input trace every time.
+  NOTE:
+   1) Input is sampled once per simulation tick, StepInputTrace() must be called at the start of every
+      fixed step and BeginInputTraceFrame() once per rendered frame (the wheel is consumed by the first tick).
+   2) Pressed/released are derived from the down state of two consecutive ticks, so they replay exactly
+      whatever the render frame rate is.
+   3) Recording format (little endian, as written by the machine):
+        header: "RLIT", version (int), fixed step (float)
+        tick:   mouse x, y, wheel (float), mouse buttons (u8), key count (u8), keys (u16)
+      14 bytes per tick plus 2 per held key. Wall frame times are not recorded, a replay only depends on the ticks.
+   4) At most INPUT_TRACE_MAX_KEYS keys held at the same time are recorded.
+
+  Return values: BeginInputRecording()/BeginInputReplay() return false if the file can not be opened or is not a trace,
+                 StepInputTrace() returns false when a replay reaches the end of the trace
+*/
+#include <stdio.h>
+#include <string.h>
+
+#define INPUT_TRACE_MAX_KEYS    32
+#define INPUT_TRACE_VERSION     2
+
+typedef enum {
+    INPUT_TRACE_LIVE = 0,
+    INPUT_TRACE_RECORD,
+    INPUT_TRACE_REPLAY
+} InputTraceMode;
+
+typedef struct InputTick {
+    Vector2 mousePosition;
+    float mouseWheel;
+    unsigned char mouseButtons;         // bit per MOUSE_BUTTON_*
+    unsigned char keyCount;
+    unsigned short keys[INPUT_TRACE_MAX_KEYS];     // keys down, sorted
+} InputTick;
+
+typedef struct InputTrace {
+    InputTraceMode mode;
+    float fixedStep;                    // simulation step in seconds
+    FILE *file;
+    int tick;                           // ticks stepped so far
+    float pendingWheel;                 // wheel of the current frame, not consumed by a tick yet
+    InputTick current;
+    InputTick previous;
+} InputTrace;
+
+// Live input, nothing recorded
+void InitInputTrace(InputTrace *trace, float fixedStep)
+{
+    memset(trace, 0, sizeof(InputTrace));
+    trace->fixedStep = fixedStep;
+}
+
+bool BeginInputRecording(InputTrace *trace, const char *fileName, float fixedStep)
+{
+    InitInputTrace(trace, fixedStep);
+
+    trace->file = fopen(fileName, "wb");
+    if (trace->file == NULL)
+    {
+        TRACELOG(LOG_WARNING, "INPUT: [%s] Failed to open trace for writing", fileName);
+        return false;
+    }
+
+    int version = INPUT_TRACE_VERSION;
+    fwrite("RLIT", 1, 4, trace->file);
+    fwrite(&version, sizeof(int), 1, trace->file);
+    fwrite(&fixedStep, sizeof(float), 1, trace->file);
+
+    trace->mode = INPUT_TRACE_RECORD;
+    TRACELOG(LOG_INFO, "INPUT: [%s] Recording input, fixed step %.4f s", fileName, fixedStep);
+    return true;
+}
+
+// The fixed step is taken from the recording
+bool BeginInputReplay(InputTrace *trace, const char *fileName)
+{
+    InitInputTrace(trace, 0.0f);
+
+    trace->file = fopen(fileName, "rb");
+    if (trace->file == NULL)
+    {
+        TRACELOG(LOG_WARNING, "INPUT: [%s] Failed to open trace", fileName);
+        return false;
+    }
+
+    char magic[4] = { 0 };
+    int version = 0;
+    if ((fread(magic, 1, 4, trace->file) != 4) || (memcmp(magic, "RLIT", 4) != 0) ||
+        (fread(&version, sizeof(int), 1, trace->file) != 1) || (version != INPUT_TRACE_VERSION) ||
+        (fread(&trace->fixedStep, sizeof(float), 1, trace->file) != 1) || (trace->fixedStep <= 0.0f))
+    {
+        TRACELOG(LOG_WARNING, "INPUT: [%s] Not an input trace or wrong version", fileName);
+        fclose(trace->file);
+        trace->file = NULL;
+        return false;
+    }
+
+    trace->mode = INPUT_TRACE_REPLAY;
+    TRACELOG(LOG_INFO, "INPUT: [%s] Replaying input, fixed step %.4f s", fileName, trace->fixedStep);
+    return true;
+}
+
+void EndInputTrace(InputTrace *trace)
+{
+    if (trace->file != NULL) fclose(trace->file);
+    trace->file = NULL;
+    trace->mode = INPUT_TRACE_LIVE;
+}
+
+// Call once per rendered frame, before the fixed steps of that frame
+void BeginInputTraceFrame(InputTrace *trace)
+{
+    if (trace->mode != INPUT_TRACE_REPLAY) trace->pendingWheel += GetMouseWheelMove();
+}
+
+static void SampleInputTick(InputTrace *trace, InputTick *tick)
+{
+    memset(tick, 0, sizeof(InputTick));
+    tick->mousePosition = GetMousePosition();
+    tick->mouseWheel = trace->pendingWheel;
+    trace->pendingWheel = 0.0f;
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++)
+    {
+        if (IsMouseButtonDown(button)) tick->mouseButtons |= (unsigned char)(1 << button);
+    }
+
+    for (int key = KEY_SPACE; (key <= KEY_KB_MENU) && (tick->keyCount < INPUT_TRACE_MAX_KEYS); key++)
+    {
+        if (IsKeyDown(key)) tick->keys[tick->keyCount++] = (unsigned short)key;
+    }
+}
+
+static void WriteInputTick(FILE *file, const InputTick *tick)
+{
+    fwrite(&tick->mousePosition, sizeof(float), 2, file);
+    fwrite(&tick->mouseWheel, sizeof(float), 1, file);
+    fwrite(&tick->mouseButtons, 1, 1, file);
+    fwrite(&tick->keyCount, 1, 1, file);
+    fwrite(tick->keys, sizeof(unsigned short), tick->keyCount, file);
+}
+
+static bool ReadInputTick(FILE *file, InputTick *tick)
+{
+    memset(tick, 0, sizeof(InputTick));
+
+    if ((fread(&tick->mousePosition, sizeof(float), 2, file) != 2) ||
+        (fread(&tick->mouseWheel, sizeof(float), 1, file) != 1) ||
+        (fread(&tick->mouseButtons, 1, 1, file) != 1) ||
+        (fread(&tick->keyCount, 1, 1, file) != 1) ||
+        (tick->keyCount > INPUT_TRACE_MAX_KEYS) ||
+        (fread(tick->keys, sizeof(unsigned short), tick->keyCount, file) != tick->keyCount)) return false;
+
+    return true;
+}
+
+// Advance the input by one simulation tick
+bool StepInputTrace(InputTrace *trace)
+{
+    trace->previous = trace->current;
+
+    if (trace->mode == INPUT_TRACE_REPLAY)
+    {
+        if (!ReadInputTick(trace->file, &trace->current))
+        {
+            memset(&trace->current, 0, sizeof(InputTick));
+            return false;
+        }
+    }
+    else
+    {
+        SampleInputTick(trace, &trace->current);
+        if (trace->mode == INPUT_TRACE_RECORD) WriteInputTick(trace->file, &trace->current);
+    }
+
+    trace->tick++;
+    return true;
+}
+
+static bool TickKeyDown(const InputTick *tick, int key)
+{
+    for (int i = 0; i < tick->keyCount; i++) if (tick->keys[i] == key) return true;
+    return false;
+}
+
+bool TraceIsKeyDown(const InputTrace *trace, int key) { return TickKeyDown(&trace->current, key); }
+bool TraceIsKeyPressed(const InputTrace *trace, int key) { return TickKeyDown(&trace->current, key) && !TickKeyDown(&trace->previous, key); }
+bool TraceIsKeyReleased(const InputTrace *trace, int key) { return !TickKeyDown(&trace->current, key) && TickKeyDown(&trace->previous, key); }
+bool TraceIsMouseButtonDown(const InputTrace *trace, int button) { return (trace->current.mouseButtons >> button) & 1; }
+bool TraceIsMouseButtonPressed(const InputTrace *trace, int button) { return ((trace->current.mouseButtons & ~trace->previous.mouseButtons) >> button) & 1; }
+Vector2 TraceGetMousePosition(const InputTrace *trace) { return trace->current.mousePosition; }
+Vector2 TraceGetMouseDelta(const InputTrace *trace)
+{
+    return (Vector2){ trace->current.mousePosition.x - trace->previous.mousePosition.x, trace->current.mousePosition.y - trace->previous.mousePosition.y };
+}
+float TraceGetMouseWheelMove(const InputTrace *trace) { return trace->current.mouseWheel; }
+
+// example usage
+// InputTrace input;
+// BeginInputRecording(&input, "input_trace.bin", 1.0f/60.0f);
+// while (!WindowShouldClose())
+// {
+//     BeginInputTraceFrame(&input);
+//     for (accumulator += GetFrameTime(); accumulator >= input.fixedStep; accumulator -= input.fixedStep)
+//     {
+//         StepInputTrace(&input);
+//         if (TraceIsKeyPressed(&input, KEY_SPACE)) ...
+//     }
+//     ...
+// }
+// EndInputTrace(&input);
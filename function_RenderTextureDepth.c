@@ -0,0 +1,100 @@
+/* Render textures with an explicit colour format and depth/stencil renderbuffer format, or with a depth
+   renderbuffer shared between several render textures.
+  NOTE:
+   1) The depth format is stored in target.depth.format as a RenderTextureDepthFormat, NOT a raylib
+      PixelFormat (raylib has no depth pixel formats).
+   2) LoadRenderTextureSharedDepth() only attaches the given renderbuffer, unload those targets with
+      UnloadRenderTextureDepth(target, false) and delete the shared renderbuffer once.
+   3) Depth/stencil renderbuffers need OpenGL 3.3 or GL_OES_packed_depth_stencil on OpenGL ES 2.0.
+
+  Functions:  LoadDepthRenderbuffer(width, height, depthFormat)                  = renderbuffer id, 0 for RT_DEPTH_NONE
+              LoadRenderTextureDepth(width, height, colorFormat, depthFormat)    = colour texture + own depth renderbuffer
+              LoadRenderTextureSharedDepth(width, height, colorFormat, depthId, depthFormat)
+                                                                                 = colour texture + existing depth renderbuffer
+              UnloadRenderTextureDepth(target, unloadDepth)                      = delete fbo, colour and (optionally) depth
+*/
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+// Depth/stencil formats of render texture renderbuffers
+typedef enum {
+    RT_DEPTH_NONE = 0,
+    RT_DEPTH_24,                        // GL_DEPTH_COMPONENT24 renderbuffer
+    RT_DEPTH_24_STENCIL_8               // GL_DEPTH24_STENCIL8 renderbuffer
+} RenderTextureDepthFormat;
+
+unsigned int LoadDepthRenderbuffer(int width, int height, int depthFormat)
+{
+    unsigned int id = 0;
+    if (depthFormat == RT_DEPTH_NONE) return id;
+
+    glGenRenderbuffers(1, &id);
+    glBindRenderbuffer(GL_RENDERBUFFER, id);
+    glRenderbufferStorage(GL_RENDERBUFFER, (depthFormat == RT_DEPTH_24_STENCIL_8)? GL_DEPTH24_STENCIL8 : GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    TRACELOG(LOG_INFO, "TEXTURE: [ID %i] Depth%s renderbuffer loaded successfully", id, (depthFormat == RT_DEPTH_24_STENCIL_8)? "/Stencil" : "");
+    return id;
+}
+
+// Create framebuffer with a colour texture and the given depth(/stencil) renderbuffer attached
+RenderTexture2D LoadRenderTextureSharedDepth(int width, int height, int colorFormat, unsigned int depthId, int depthFormat)
+{
+    RenderTexture2D target = { 0 };
+
+    target.id = rlLoadFramebuffer(); // Load an empty framebuffer
+
+    if (target.id > 0)
+    {
+        rlEnableFramebuffer(target.id);
+
+        target.texture.id = rlLoadTexture(NULL, width, height, colorFormat, 1);
+        target.texture.width = width;
+        target.texture.height = height;
+        target.texture.format = colorFormat;
+        target.texture.mipmaps = 1;
+
+        rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+
+        if ((depthFormat != RT_DEPTH_NONE) && (depthId > 0))
+        {
+            target.depth.id = depthId;
+            target.depth.width = width;
+            target.depth.height = height;
+            target.depth.format = depthFormat;
+            target.depth.mipmaps = 1;
+
+            glBindFramebuffer(GL_FRAMEBUFFER, target.id);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, (depthFormat == RT_DEPTH_24_STENCIL_8)? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthId);
+        }
+
+        // Check if fbo is complete with attachments (valid)
+        if (rlFramebufferComplete(target.id)) TRACELOG(LOG_INFO, "FBO: [ID %i] Framebuffer object %ix%i created successfully", target.id, width, height);
+
+        rlDisableFramebuffer();
+    }
+    else TRACELOG(LOG_WARNING, "FBO: Framebuffer object can not be created");
+
+    return target;
+}
+
+// Create framebuffer with a colour texture and its own depth(/stencil) renderbuffer
+RenderTexture2D LoadRenderTextureDepth(int width, int height, int colorFormat, int depthFormat)
+{
+    unsigned int depthId = LoadDepthRenderbuffer(width, height, depthFormat);
+    RenderTexture2D target = LoadRenderTextureSharedDepth(width, height, colorFormat, depthId, depthFormat);
+
+    if ((target.id == 0) && (depthId > 0)) glDeleteRenderbuffers(1, &depthId);
+
+    return target;
+}
+
+void UnloadRenderTextureDepth(RenderTexture2D target, bool unloadDepth)
+{
+    if (target.id == 0) return;
+
+    rlUnloadTexture(target.texture.id);
+    if (unloadDepth && (target.depth.id > 0)) glDeleteRenderbuffers(1, &target.depth.id);
+    glDeleteFramebuffers(1, &target.id);      // not rlUnloadFramebuffer(), it also deletes the depth attachment
+}
@@ -0,0 +1,50 @@
+/* Immediate stencil mask helpers, from https://github.com/raysan5/raylib/discussions/2964
+  NOTE:
+   1) The render target needs a stencil buffer, e.g. LoadRenderTextureDepth(w, h, format, RT_DEPTH_24_STENCIL_8)
+      from function_RenderTextureDepth.c.
+   2) Every mode change flushes the raylib batch, stencilForcedFlushes counts those flushes (reset it as needed).
+
+  Usage:  ClearStencilMask(); BeginStencilMode(); BeginStencilMask(); ...mask shapes... EndStencilMask();
+          ...content drawn where the mask is... EndStencilMode();
+*/
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+
+int stencilForcedFlushes = 0;       // rlDrawRenderBatchActive() calls done because of stencil changes
+
+void BeginStencilMode()
+{
+	rlDrawRenderBatchActive();
+	stencilForcedFlushes++;
+	glEnable(GL_STENCIL_TEST);
+}
+
+void ClearStencilMask()
+{
+	glClearStencil(0);
+	glClear( GL_STENCIL_BUFFER_BIT );
+}
+
+void BeginStencilMask()
+{
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glStencilFunc(GL_ALWAYS, 1, 0xFF);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+}
+
+void EndStencilMask()
+{
+	rlDrawRenderBatchActive();
+	stencilForcedFlushes++;
+	glStencilFunc(GL_EQUAL, 1, 0xFF);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void EndStencilMode()
+{
+	rlDrawRenderBatchActive();
+	stencilForcedFlushes++;
+	glDisable(GL_STENCIL_TEST);
+}
@@ -0,0 +1,557 @@
+/* Pre-processed texture cache: a cooker writes the full mip chain of an image to a cache file, optionally
+   BC1/BC3 (DXT1/DXT5) compressed, and the loader memory-maps that file and uploads every level straight
+   from the mapping. No image decode and no GPU mipmap generation at runtime.
+  NOTE:
+   1) File layout: TextureCacheHeader (64 bytes) followed by the mip levels, largest first, packed the way
+      rlLoadTexture() reads them (level size = GetPixelDataSize(w, h, format), w and h halved per level).
+   2) Cache files are named after the image plus a hash of its full path (a/wall.png and b/wall.png get
+      different files). The header keeps that path hash and the size and modification time of the source,
+      LoadTextureCached() cooks again when any of them differs or the cache is missing/corrupt (first run).
+      Files are written to <name>.tmp and then renamed, an interrupted cook never leaves a truncated cache behind.
+   3) TEXTURE_CACHE_BC picks BC1 (4 bpp, 8x smaller than RGBA8) for opaque images and BC3 (8 bpp, 4x smaller)
+      when any alpha is below 255. It needs width and height multiples of 4, the chain stops at the last level
+      whose size still is a multiple of 4 (GL_TEXTURE_MAX_LEVEL is set accordingly). Other sizes, and GPUs
+      without GL_EXT_texture_compression_s3tc, get an RGBA8 cache instead.
+   4) The block encoder fits the endpoints on the principal axis of each 4x4 block, blocks are split by block
+      rows over every core (see SetTextureCacheThreads()). PLATFORM_WEB and TEXTURE_CACHE_SINGLE_THREAD builds
+      encode on the calling thread.
+   5) Files are mapped with mmap() on POSIX systems. _WIN32 and PLATFORM_WEB builds (or TEXTURE_CACHE_NO_MMAP)
+      read the file with LoadFileData() instead, still without any decode.
+
+  Functions:  LoadTextureCached(fileName, cacheDir, format)    = cook on first run, then map and upload
+              CookTextureCache(fileName, cacheFileName, format)= offline cooker, returns false on failure
+              LoadTextureCacheFile(cacheFileName)              = map and upload an existing cache file
+              IsTextureCacheValid(cacheFileName, fileName)     = cache exists and matches the source image
+              GetTextureCacheFileName(fileName, cacheDir, format) = cache file used for an image
+              GetTextureVramSize(texture)                      = bytes taken by all mip levels of a texture
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"
+#include <external/glfw/include/GLFW/glfw3.h>      // Required for: glfwExtensionSupported()
+
+#if (defined(_WIN32) || defined(PLATFORM_WEB)) && !defined(TEXTURE_CACHE_NO_MMAP)
+    #define TEXTURE_CACHE_NO_MMAP
+#endif
+#if !defined(TEXTURE_CACHE_NO_MMAP)
+    #include <fcntl.h>          // Required for: open()
+    #include <sys/mman.h>       // Required for: mmap(), munmap(), madvise()
+    #include <sys/stat.h>       // Required for: fstat()
+    #include <unistd.h>         // Required for: close()
+#endif
+
+#if defined(PLATFORM_WEB) && !defined(TEXTURE_CACHE_SINGLE_THREAD)
+    #define TEXTURE_CACHE_SINGLE_THREAD
+#endif
+#if !defined(TEXTURE_CACHE_SINGLE_THREAD)
+    #include <pthread.h>
+    #include <unistd.h>         // Required for: sysconf()
+#endif
+
+#define TEXTURE_CACHE_MAGIC             0x43544c52      // "RLTC"
+#define TEXTURE_CACHE_VERSION           2
+#define TEXTURE_CACHE_MAX_THREADS       32
+#define TEXTURE_CACHE_PARALLEL_BLOCKS   4096            // smaller levels are encoded on the calling thread
+
+#if !defined(GL_TEXTURE_MAX_LEVEL)
+    #define GL_TEXTURE_MAX_LEVEL        0x813D
+#endif
+
+typedef enum {
+    TEXTURE_CACHE_RGBA8 = 0,        // uncompressed, full mip chain
+    TEXTURE_CACHE_BC                // BC1 when opaque, BC3 with alpha
+} TextureCacheFormat;
+
+typedef struct TextureCacheHeader {
+    unsigned int magic;
+    int version;
+    int width;
+    int height;
+    int format;                     // PixelFormat of the levels
+    int mipmaps;
+    long long sourceModTime;        // GetFileModTime() of the source image when cooked
+    long long dataSize;             // bytes of level data following the header
+    long long sourceSize;           // GetFileLength() of the source image when cooked
+    unsigned long long pathHash;    // HashSourcePath() of the source image
+    char reserved[8];
+} TextureCacheHeader;
+
+static int textureCacheThreads = 0;             // 0 = one per core
+
+// Threads used by the block encoder, 0 uses one per core
+void SetTextureCacheThreads(int threads)
+{
+    textureCacheThreads = (threads < 0)? 0 : threads;
+}
+
+//----------------------------------------------------------------------------------
+// BC1/BC3 block encoder
+//----------------------------------------------------------------------------------
+static unsigned short PackColor565(const float c[3])
+{
+    int r = (int)(c[0]*31.0f/255.0f + 0.5f);
+    int g = (int)(c[1]*63.0f/255.0f + 0.5f);
+    int b = (int)(c[2]*31.0f/255.0f + 0.5f);
+    r = (r < 0)? 0 : (r > 31)? 31 : r;
+    g = (g < 0)? 0 : (g > 63)? 63 : g;
+    b = (b < 0)? 0 : (b > 31)? 31 : b;
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackColor565(unsigned short c, int rgb[3])
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 color block (8 bytes) of 16 RGBA pixels, always in 4 color mode (as BC3 requires)
+static void EncodeColorBlock(const unsigned char *pixels, unsigned char *out)
+{
+    // Principal axis of the block colors: mean, covariance, a few power iterations
+    float mean[3] = { 0 };
+    for (int i = 0; i < 16; i++) for (int c = 0; c < 3; c++) mean[c] += pixels[i*4 + c];
+    for (int c = 0; c < 3; c++) mean[c] /= 16.0f;
+
+    float cov[6] = { 0 };           // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++)
+    {
+        float r = pixels[i*4] - mean[0], g = pixels[i*4 + 1] - mean[1], b = pixels[i*4 + 2] - mean[2];
+        cov[0] += r*r; cov[1] += r*g; cov[2] += r*b; cov[3] += g*g; cov[4] += g*b; cov[5] += b*b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int it = 0; it < 4; it++)
+    {
+        float x = cov[0]*axis[0] + cov[1]*axis[1] + cov[2]*axis[2];
+        float y = cov[1]*axis[0] + cov[3]*axis[1] + cov[4]*axis[2];
+        float z = cov[2]*axis[0] + cov[4]*axis[1] + cov[5]*axis[2];
+        float m = (x*x > y*y)? ((x*x > z*z)? x : z) : ((y*y > z*z)? y : z);
+        if (m*m < 1e-12f) break;    // flat block, any axis works
+        axis[0] = x/m; axis[1] = y/m; axis[2] = z/m;
+    }
+
+    // Endpoints: extreme projections on the axis, inset by 1/16 of the range to cut the error at the ends
+    float minDot = 1e30f, maxDot = -1e30f;
+    for (int i = 0; i < 16; i++)
+    {
+        float d = (pixels[i*4] - mean[0])*axis[0] + (pixels[i*4 + 1] - mean[1])*axis[1] + (pixels[i*4 + 2] - mean[2])*axis[2];
+        if (d < minDot) minDot = d;
+        if (d > maxDot) maxDot = d;
+    }
+    float axisLength2 = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+    float inset = (maxDot - minDot)/16.0f;
+    float e0[3], e1[3];
+    for (int c = 0; c < 3; c++)
+    {
+        e0[c] = mean[c] + axis[c]*(maxDot - inset)/axisLength2;
+        e1[c] = mean[c] + axis[c]*(minDot + inset)/axisLength2;
+    }
+
+    unsigned short c0 = PackColor565(e0);
+    unsigned short c1 = PackColor565(e1);
+    if (c0 < c1) { unsigned short t = c0; c0 = c1; c1 = t; }
+
+    unsigned int indices = 0;
+    if (c0 != c1)
+    {
+        int palette[4][3];
+        UnpackColor565(c0, palette[0]);
+        UnpackColor565(c1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2*palette[0][c] + palette[1][c] + 1)/3;
+            palette[3][c] = (palette[0][c] + 2*palette[1][c] + 1)/3;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestError = 0x7fffffff;
+            for (int p = 0; p < 4; p++)
+            {
+                int dr = pixels[i*4] - palette[p][0], dg = pixels[i*4 + 1] - palette[p][1], db = pixels[i*4 + 2] - palette[p][2];
+                int error = dr*dr + dg*dg + db*db;
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= (unsigned int)best << (i*2);
+        }
+    }
+
+    out[0] = c0 & 0xff; out[1] = c0 >> 8;
+    out[2] = c1 & 0xff; out[3] = c1 >> 8;
+    out[4] = indices & 0xff; out[5] = (indices >> 8) & 0xff; out[6] = (indices >> 16) & 0xff; out[7] = indices >> 24;
+}
+
+// BC3 alpha block (8 bytes) of 16 RGBA pixels, 8 value mode between min and max alpha
+static void EncodeAlphaBlock(const unsigned char *pixels, unsigned char *out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        if (pixels[i*4 + 3] > a0) a0 = pixels[i*4 + 3];
+        if (pixels[i*4 + 3] < a1) a1 = pixels[i*4 + 3];
+    }
+
+    unsigned long long indices = 0;
+    if (a0 != a1)
+    {
+        int palette[8] = { a0, a1 };
+        for (int p = 1; p < 7; p++) palette[p + 1] = ((7 - p)*a0 + p*a1 + 3)/7;
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestError = 256;
+            for (int p = 0; p < 8; p++)
+            {
+                int error = abs(pixels[i*4 + 3] - palette[p]);
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= (unsigned long long)best << (i*3);
+        }
+    }
+
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int b = 0; b < 6; b++) out[2 + b] = (unsigned char)(indices >> (b*8));
+}
+
+typedef struct BlockEncodeArgs {
+    const unsigned char *pixels;    // R8G8B8A8 level
+    unsigned char *blocks;
+    int width;                      // multiple of 4
+    int blockBytes;                 // 8 for BC1, 16 for BC3
+} BlockEncodeArgs;
+
+static void EncodeBlockRows(const BlockEncodeArgs *args, int firstRow, int rowCount)
+{
+    int blocksX = args->width/4;
+    unsigned char block[16*4];
+    unsigned char *out = args->blocks + (size_t)firstRow*blocksX*args->blockBytes;
+
+    for (int by = firstRow; by < firstRow + rowCount; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++, out += args->blockBytes)
+        {
+            for (int y = 0; y < 4; y++) memcpy(block + y*16, args->pixels + ((size_t)(by*4 + y)*args->width + bx*4)*4, 16);
+
+            if (args->blockBytes == 16)
+            {
+                EncodeAlphaBlock(block, out);
+                EncodeColorBlock(block, out + 8);
+            }
+            else EncodeColorBlock(block, out);
+        }
+    }
+}
+
+#if !defined(TEXTURE_CACHE_SINGLE_THREAD)
+typedef struct BlockEncodeTask {
+    const BlockEncodeArgs *args;
+    int firstRow;
+    int rowCount;
+    pthread_t thread;
+    bool started;                       // false: thread could not be created, the rows were encoded inline
+} BlockEncodeTask;
+
+static void *BlockEncodeThread(void *arg)
+{
+    BlockEncodeTask *task = (BlockEncodeTask *)arg;
+    EncodeBlockRows(task->args, task->firstRow, task->rowCount);
+    return NULL;
+}
+#endif
+
+// Encode one R8G8B8A8 level (width and height multiples of 4), split by block rows over the threads
+static void EncodeLevelBC(const unsigned char *pixels, unsigned char *blocks, int width, int height, bool alpha)
+{
+    BlockEncodeArgs args = { pixels, blocks, width, alpha? 16 : 8 };
+    int blockRows = height/4;
+
+#if !defined(TEXTURE_CACHE_SINGLE_THREAD)
+    int threads = (textureCacheThreads > 0)? textureCacheThreads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > TEXTURE_CACHE_MAX_THREADS) threads = TEXTURE_CACHE_MAX_THREADS;
+    if (threads > blockRows) threads = blockRows;
+
+    if ((threads > 1) && ((width/4)*blockRows >= TEXTURE_CACHE_PARALLEL_BLOCKS))
+    {
+        BlockEncodeTask tasks[TEXTURE_CACHE_MAX_THREADS];
+        int rowsPerTask = (blockRows + threads - 1)/threads;
+
+        for (int t = 0; t < threads; t++)
+        {
+            int firstRow = t*rowsPerTask;
+            int rows = (firstRow + rowsPerTask > blockRows)? blockRows - firstRow : rowsPerTask;
+            tasks[t] = (BlockEncodeTask){ .args = &args, .firstRow = firstRow, .rowCount = (rows > 0)? rows : 0 };
+            if (t > 0)
+            {
+                tasks[t].started = (pthread_create(&tasks[t].thread, NULL, BlockEncodeThread, &tasks[t]) == 0);
+                if (!tasks[t].started) EncodeBlockRows(&args, tasks[t].firstRow, tasks[t].rowCount);
+            }
+        }
+
+        EncodeBlockRows(&args, tasks[0].firstRow, tasks[0].rowCount);     // first block rows on the calling thread
+        for (int t = 1; t < threads; t++) if (tasks[t].started) pthread_join(tasks[t].thread, NULL);
+        return;
+    }
+#endif
+    EncodeBlockRows(&args, 0, blockRows);
+}
+
+//----------------------------------------------------------------------------------
+// Cache files
+//----------------------------------------------------------------------------------
+
+// Bytes of all mip levels, sized the way rlLoadTexture() walks them
+static long long GetMipChainSize(int width, int height, int format, int mipmaps)
+{
+    long long size = 0;
+    for (int i = 0; i < mipmaps; i++)
+    {
+        size += GetPixelDataSize(width, height, format);
+        width = (width/2 < 1)? 1 : width/2;
+        height = (height/2 < 1)? 1 : height/2;
+    }
+    return size;
+}
+
+// FNV-1a 64 bit of the source path, images with the same name in different directories get different caches
+static unsigned long long HashSourcePath(const char *fileName)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    while (*fileName) { hash ^= (unsigned char)*fileName++; hash *= 1099511628211ull; }
+    return hash;
+}
+
+// Cache file used for an image: <cacheDir>/<name>.<path hash>.<rgba8|bc>.rltc
+const char *GetTextureCacheFileName(const char *fileName, const char *cacheDir, TextureCacheFormat format)
+{
+    static char cacheFileName[1024];
+    snprintf(cacheFileName, sizeof(cacheFileName), "%s/%s.%016llx.%s.rltc", cacheDir, GetFileNameWithoutExt(fileName),
+        HashSourcePath(fileName), (format == TEXTURE_CACHE_BC)? "bc" : "rgba8");
+    return cacheFileName;
+}
+
+// Cook an image into a cache file: decode, CPU mip chain, optional BC1/BC3 encode
+bool CookTextureCache(const char *fileName, const char *cacheFileName, TextureCacheFormat format)
+{
+    Image image = LoadImage(fileName);
+    if (image.data == NULL) return false;
+
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    ImageMipmaps(&image);           // full chain, levels packed one after the other
+
+    TextureCacheHeader header = { 0 };
+    header.magic = TEXTURE_CACHE_MAGIC;
+    header.version = TEXTURE_CACHE_VERSION;
+    header.width = image.width;
+    header.height = image.height;
+    header.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    header.mipmaps = image.mipmaps;
+    header.sourceModTime = GetFileModTime(fileName);
+    header.sourceSize = GetFileLength(fileName);
+    header.pathHash = HashSourcePath(fileName);
+
+    unsigned char *levels = (unsigned char *)image.data;
+    unsigned char *blocks = NULL;
+
+    if (format == TEXTURE_CACHE_BC)
+    {
+        if (((image.width%4) != 0) || ((image.height%4) != 0))
+        {
+            TRACELOG(LOG_WARNING, "TEXCACHE: [%s] %ix%i is not a multiple of 4, cached as RGBA8", fileName, image.width, image.height);
+        }
+        else
+        {
+            bool alpha = false;
+            const unsigned char *pixels = (const unsigned char *)image.data;
+            for (int i = 0; (i < image.width*image.height) && !alpha; i++) alpha = (pixels[i*4 + 3] < 255);
+
+            header.format = alpha? PIXELFORMAT_COMPRESSED_DXT5_RGBA : PIXELFORMAT_COMPRESSED_DXT1_RGB;
+
+            // Keep the levels whose size still is a multiple of 4
+            int levelCount = 0;
+            for (int w = image.width, h = image.height; (levelCount < image.mipmaps) && ((w%4) == 0) && ((h%4) == 0); w /= 2, h /= 2) levelCount++;
+            header.mipmaps = levelCount;
+
+            blocks = (unsigned char *)RL_MALLOC((size_t)GetMipChainSize(image.width, image.height, header.format, levelCount));
+
+            const unsigned char *src = pixels;
+            unsigned char *dst = blocks;
+            for (int i = 0, w = image.width, h = image.height; i < levelCount; i++, w /= 2, h /= 2)
+            {
+                EncodeLevelBC(src, dst, w, h, alpha);
+                src += GetPixelDataSize(w, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+                dst += GetPixelDataSize(w, h, header.format);
+            }
+            levels = blocks;
+        }
+    }
+
+    header.dataSize = GetMipChainSize(header.width, header.height, header.format, header.mipmaps);
+
+    // Write to a temporary file and rename, readers never see a partial cache
+    char tempFileName[1024];
+    snprintf(tempFileName, sizeof(tempFileName), "%s.tmp", cacheFileName);
+
+    bool success = false;
+    FILE *file = fopen(tempFileName, "wb");
+    if (file != NULL)
+    {
+        success = (fwrite(&header, sizeof(header), 1, file) == 1) && (fwrite(levels, 1, (size_t)header.dataSize, file) == (size_t)header.dataSize);
+        success = (fclose(file) == 0) && success;
+#if defined(_WIN32)
+        if (success) remove(cacheFileName);    // rename() does not replace existing files on Windows
+#endif
+        if (success) success = (rename(tempFileName, cacheFileName) == 0);     // atomic replace on POSIX
+        if (!success) remove(tempFileName);
+    }
+
+    if (success) TRACELOG(LOG_INFO, "TEXCACHE: [%s] Cooked %ix%i, %i levels, %lld bytes", cacheFileName, header.width, header.height, header.mipmaps, header.dataSize);
+    else TRACELOG(LOG_WARNING, "TEXCACHE: [%s] Failed to write cache file", cacheFileName);
+
+    if (blocks != NULL) RL_FREE(blocks);
+    UnloadImage(image);
+
+    return success;
+}
+
+// Map a whole file read only, NULL on failure
+static unsigned char *MapCacheFile(const char *cacheFileName, size_t *size)
+{
+#if !defined(TEXTURE_CACHE_NO_MMAP)
+    int fd = open(cacheFileName, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+    {
+        *size = (size_t)info.st_size;
+        data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);                      // the mapping stays valid
+
+    if (data == MAP_FAILED) return NULL;
+    madvise(data, *size, MADV_SEQUENTIAL);
+    return (unsigned char *)data;
+#else
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(cacheFileName, &dataSize);
+    *size = (size_t)dataSize;
+    return data;
+#endif
+}
+
+static void UnmapCacheFile(unsigned char *data, size_t size)
+{
+#if !defined(TEXTURE_CACHE_NO_MMAP)
+    munmap(data, size);
+#else
+    UnloadFileData(data);
+#endif
+}
+
+// Header checks shared by the loader and IsTextureCacheValid()
+static bool IsTextureCacheHeaderValid(const TextureCacheHeader *header, long long fileSize)
+{
+    if ((header->magic != TEXTURE_CACHE_MAGIC) || (header->version != TEXTURE_CACHE_VERSION)) return false;
+    if ((header->width <= 0) || (header->height <= 0) || (header->mipmaps <= 0) || (header->mipmaps > 32)) return false;
+    if ((header->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) && (header->format != PIXELFORMAT_COMPRESSED_DXT1_RGB) &&
+        (header->format != PIXELFORMAT_COMPRESSED_DXT5_RGBA)) return false;
+
+    return (header->dataSize == GetMipChainSize(header->width, header->height, header->format, header->mipmaps)) &&
+           ((long long)sizeof(TextureCacheHeader) + header->dataSize <= fileSize);
+}
+
+// Check a cache file exists and was cooked from the current version of the source image
+bool IsTextureCacheValid(const char *cacheFileName, const char *fileName)
+{
+    FILE *file = fopen(cacheFileName, "rb");
+    if (file == NULL) return false;
+
+    TextureCacheHeader header = { 0 };
+    bool valid = (fread(&header, sizeof(header), 1, file) == 1);
+    fseek(file, 0, SEEK_END);
+    long long fileSize = ftell(file);
+    fclose(file);
+
+    return valid && IsTextureCacheHeaderValid(&header, fileSize) && (header.pathHash == HashSourcePath(fileName)) &&
+           (header.sourceModTime == GetFileModTime(fileName)) && (header.sourceSize == GetFileLength(fileName));
+}
+
+// Map a cache file and upload all its levels straight from the mapping
+Texture2D LoadTextureCacheFile(const char *cacheFileName)
+{
+    Texture2D texture = { 0 };
+
+    size_t size = 0;
+    unsigned char *data = MapCacheFile(cacheFileName, &size);
+    if (data == NULL) return texture;
+
+    TextureCacheHeader header = { 0 };
+    if (size >= sizeof(header)) memcpy(&header, data, sizeof(header));
+
+    if (IsTextureCacheHeaderValid(&header, (long long)size))
+    {
+        texture.id = rlLoadTexture(data + sizeof(header), header.width, header.height, header.format, header.mipmaps);
+        if (texture.id != 0)
+        {
+            texture.width = header.width;
+            texture.height = header.height;
+            texture.mipmaps = header.mipmaps;
+            texture.format = header.format;
+
+            // A truncated BC chain must not leave the sampler looking for the missing small levels
+            glBindTexture(GL_TEXTURE_2D, texture.id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header.mipmaps - 1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
+    else TRACELOG(LOG_WARNING, "TEXCACHE: [%s] Invalid cache file", cacheFileName);
+
+    UnmapCacheFile(data, size);
+
+    return texture;
+}
+
+// Load a texture through the cache, cooking it first when missing or older than the source image
+Texture2D LoadTextureCached(const char *fileName, const char *cacheDir, TextureCacheFormat format)
+{
+    if ((format == TEXTURE_CACHE_BC) && !glfwExtensionSupported("GL_EXT_texture_compression_s3tc"))
+    {
+        TRACELOG(LOG_WARNING, "TEXCACHE: S3TC not supported, using RGBA8 cache");
+        format = TEXTURE_CACHE_RGBA8;
+    }
+
+    char cacheFileName[1024];
+    strncpy(cacheFileName, GetTextureCacheFileName(fileName, cacheDir, format), sizeof(cacheFileName) - 1);
+    cacheFileName[sizeof(cacheFileName) - 1] = '\0';
+
+    Texture2D texture = { 0 };
+    if (IsTextureCacheValid(cacheFileName, fileName)) texture = LoadTextureCacheFile(cacheFileName);
+
+    if (texture.id == 0)
+    {
+        if (!DirectoryExists(cacheDir)) MakeDirectory(cacheDir);
+        if (CookTextureCache(fileName, cacheFileName, format)) texture = LoadTextureCacheFile(cacheFileName);
+    }
+
+    // Cache not writable: load the source the usual way
+    if (texture.id == 0)
+    {
+        texture = LoadTexture(fileName);
+        GenTextureMipmaps(&texture);
+    }
+
+    return texture;
+}
+
+// VRAM taken by all mip levels of a texture
+int GetTextureVramSize(Texture2D texture)
+{
+    return (int)GetMipChainSize(texture.width, texture.height, texture.format, texture.mipmaps);
+}